@@ -0,0 +1,153 @@
+#include <rupture/graphics/gltf/animation.h>
+#include <rupture/graphics/gltf/animation_sampler.h>
+#include <rupture/graphics/gltf/compressed_animation.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using Mode = fx::gltf::Animation::Sampler::Type;
+
+const uint32_t JOINT_COUNT = 64;
+const uint32_t KEY_COUNT = 120;
+const float KEY_INTERVAL = 1.0f / 30.0f;
+const size_t INSTANCE_COUNT = 256;
+const size_t FRAME_COUNT = 200;
+
+uint32_t addAccessor(fx::gltf::Document& document, const void* data,
+                     uint32_t count, size_t elementSize,
+                     fx::gltf::Accessor::Type type) {
+    auto& buffer = document.buffers[0];
+    auto offset = buffer.data.size();
+    buffer.data.resize(offset + count * elementSize);
+    std::memcpy(&buffer.data[offset], data, count * elementSize);
+    buffer.byteLength = static_cast<uint32_t>(buffer.data.size());
+
+    fx::gltf::BufferView view{};
+    view.buffer = 0;
+    view.byteOffset = static_cast<uint32_t>(offset);
+    view.byteLength = static_cast<uint32_t>(count * elementSize);
+    document.bufferViews.push_back(view);
+
+    fx::gltf::Accessor accessor{};
+    accessor.bufferView =
+        static_cast<int32_t>(document.bufferViews.size() - 1);
+    accessor.count = count;
+    accessor.componentType = fx::gltf::Accessor::ComponentType::Float;
+    accessor.type = type;
+    document.accessors.push_back(accessor);
+    return static_cast<uint32_t>(document.accessors.size() - 1);
+}
+
+fx::gltf::Document makeDocument(Mode mode) {
+    std::mt19937 random{42};
+    std::uniform_real_distribution<float> distribution{-1.0f, 1.0f};
+    auto next = [&]() { return distribution(random); };
+
+    fx::gltf::Document document{};
+    document.buffers.emplace_back();
+    document.nodes.resize(JOINT_COUNT);
+
+    std::vector<float> times(KEY_COUNT);
+    for (uint32_t i{0}; i < KEY_COUNT; i++) {
+        times[i] = i * KEY_INTERVAL;
+    }
+    auto input = addAccessor(document, times.data(), KEY_COUNT, sizeof(float),
+                             fx::gltf::Accessor::Type::Scalar);
+    auto outputCount = mode == Mode::CubicSpline ? KEY_COUNT * 3 : KEY_COUNT;
+
+    fx::gltf::Animation animation{};
+    for (uint32_t joint{0}; joint < JOINT_COUNT; joint++) {
+        std::vector<glm::vec3> translations(outputCount);
+        std::vector<glm::quat> rotations(outputCount);
+        for (uint32_t i{0}; i < outputCount; i++) {
+            translations[i] = glm::vec3{next(), next(), next()};
+            rotations[i] =
+                glm::normalize(glm::quat{next(), next(), next(), next()});
+        }
+        auto translationOutput = addAccessor(
+            document, translations.data(), outputCount, sizeof(glm::vec3),
+            fx::gltf::Accessor::Type::Vec3);
+        auto rotationOutput =
+            addAccessor(document, rotations.data(), outputCount,
+                        sizeof(glm::quat), fx::gltf::Accessor::Type::Vec4);
+
+        for (auto [output, path] : {std::make_pair(translationOutput,
+                                                   "translation"),
+                                    std::make_pair(rotationOutput,
+                                                   "rotation")}) {
+            fx::gltf::Animation::Sampler sampler{};
+            sampler.input = static_cast<int32_t>(input);
+            sampler.output = static_cast<int32_t>(output);
+            sampler.interpolation = mode;
+            animation.samplers.push_back(sampler);
+
+            fx::gltf::Animation::Channel channel{};
+            channel.sampler =
+                static_cast<int32_t>(animation.samplers.size() - 1);
+            channel.target.node = static_cast<int32_t>(joint);
+            channel.target.path = path;
+            animation.channels.push_back(channel);
+        }
+    }
+    document.animations.push_back(animation);
+    return document;
+}
+
+double benchmark(Mode mode, bool compressed) {
+    auto document = makeDocument(mode);
+    std::unordered_map<uint32_t, uint32_t> ordering{};
+    for (uint32_t joint{0}; joint < JOINT_COUNT; joint++) {
+        ordering.emplace(joint, joint);
+    }
+    gltf::Animation animation{document, document.animations[0], ordering};
+    auto sampler =
+        compressed ? gltf::AnimationSampler{std::make_shared<
+                         const gltf::CompressedAnimation>(animation)}
+                   : gltf::AnimationSampler{animation};
+
+    gltf::PoseBuffer pose{JOINT_COUNT, INSTANCE_COUNT};
+    std::vector<gltf::AnimationSampler::Cursor> cursors(INSTANCE_COUNT);
+    std::vector<float> times(INSTANCE_COUNT);
+    auto duration = static_cast<float>(sampler.duration());
+
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t frame{0}; frame < FRAME_COUNT; frame++) {
+        for (size_t i{0}; i < INSTANCE_COUNT; i++) {
+            times[i] =
+                std::fmod(frame / 60.0f + i * KEY_INTERVAL * 0.37f, duration);
+        }
+        sampler.sample(times.data(), cursors.data(), INSTANCE_COUNT, pose);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    auto samples = static_cast<double>(FRAME_COUNT * INSTANCE_COUNT) *
+                   document.animations[0].channels.size();
+    return std::chrono::duration<double, std::nano>(end - begin).count() /
+           samples;
+}
+
+int main() {
+    try {
+        std::cout << std::fixed << std::setprecision(2);
+        for (auto [mode, name] : {std::make_pair(Mode::Step, "Step"),
+                                  std::make_pair(Mode::Linear, "Linear"),
+                                  std::make_pair(Mode::CubicSpline,
+                                                 "CubicSpline")}) {
+            std::cout << std::setw(12) << name << ": "
+                      << benchmark(mode, false) << " ns/channel sample, "
+                      << benchmark(mode, true) << " compressed\n";
+        }
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
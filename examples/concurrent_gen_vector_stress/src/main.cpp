@@ -0,0 +1,159 @@
+#include <rupture/ecs/concurrent_gen_vector.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Interleavings only get real coverage with the threads on separate cores,
+// and reordering bugs between item words and generations (missing fences)
+// only show up on weakly ordered hardware such as ARM or POWER. A pass on a
+// single core or on x86 says little about the memory ordering.
+const size_t OPERATION_COUNT = 1000000;
+const size_t MAX_HELD = 16;
+const size_t CHUNK_SIZE = 256;
+const size_t MAX_CHUNKS = 64;
+
+struct Item {
+    uint32_t thread;
+    uint32_t sequence;
+};
+
+using Vector = ConcurrentGenerationVector<Item, CHUNK_SIZE, MAX_CHUNKS>;
+
+struct Held {
+    Vector::Index index;
+    Item item;
+};
+
+struct Worker {
+    std::vector<uint64_t> issued{};
+    std::vector<std::string> errors{};
+};
+
+uint64_t key(const Vector::Index& index) {
+    return static_cast<uint64_t>(index.index()) << 32 | index.generation();
+}
+
+void hammer(Vector& vector, std::vector<std::atomic<uint8_t>>& owned,
+            std::atomic<bool>& start, uint32_t thread, Worker& worker) {
+    std::mt19937 random{thread};
+    std::vector<Held> held{};
+    std::vector<Vector::Index> stale{};
+    worker.issued.reserve(OPERATION_COUNT);
+
+    auto fail = [&](const std::string& message) {
+        if (worker.errors.size() < 8) {
+            worker.errors.push_back("thread " + std::to_string(thread) +
+                                    ": " + message);
+        }
+    };
+
+    auto release = [&](size_t position) {
+        auto entry = held[position];
+        held[position] = held.back();
+        held.pop_back();
+        owned[entry.index.index()].store(0, std::memory_order_relaxed);
+        if (!vector.tryRemove(entry.index)) {
+            fail("remove of a held handle failed");
+        }
+        stale.push_back(entry.index);
+    };
+
+    while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+
+    for (uint32_t sequence{0}; sequence < OPERATION_COUNT; sequence++) {
+        auto roll = random() % 4;
+        if (held.size() < MAX_HELD && (roll < 2 || held.empty())) {
+            Item item{thread, sequence};
+            auto index = vector.insert(item);
+            worker.issued.push_back(key(index));
+            if (owned[index.index()].exchange(1, std::memory_order_relaxed)) {
+                fail("slot " + std::to_string(index.index()) +
+                     " handed out while still live");
+            }
+            held.push_back(Held{index, item});
+        } else if (roll == 2) {
+            release(random() % held.size());
+        } else {
+            auto& entry = held[random() % held.size()];
+            auto item = vector.get(entry.index);
+            if (!item || item->thread != entry.item.thread ||
+                item->sequence != entry.item.sequence) {
+                fail("held handle returned the wrong item");
+            }
+        }
+
+        if (!stale.empty() && random() % 8 == 0) {
+            auto index = stale[random() % stale.size()];
+            if (vector.get(index) || vector.tryRemove(index)) {
+                fail("stale handle still resolves");
+            }
+        }
+    }
+
+    while (!held.empty()) {
+        release(held.size() - 1);
+    }
+}
+
+int main() {
+    try {
+        auto threadCount = std::max(4u, std::thread::hardware_concurrency());
+        Vector vector{};
+        std::vector<std::atomic<uint8_t>> owned(CHUNK_SIZE * MAX_CHUNKS);
+        std::vector<Worker> workers(threadCount);
+        std::atomic<bool> start{false};
+
+        std::vector<std::thread> threads{};
+        for (uint32_t i{0}; i < threadCount; i++) {
+            threads.emplace_back(hammer, std::ref(vector), std::ref(owned),
+                                 std::ref(start), i, std::ref(workers[i]));
+        }
+        start.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::vector<uint64_t> issued{};
+        bool passed = true;
+        for (auto& worker : workers) {
+            issued.insert(issued.end(), worker.issued.begin(),
+                          worker.issued.end());
+            for (auto& error : worker.errors) {
+                std::cout << error << '\n';
+                passed = false;
+            }
+        }
+        std::sort(issued.begin(), issued.end());
+        auto duplicate = std::adjacent_find(issued.begin(), issued.end());
+        if (duplicate != issued.end()) {
+            std::cout << "handle " << (*duplicate >> 32) << ':'
+                      << (*duplicate & 0xffffffff) << " issued twice\n";
+            passed = false;
+        }
+        if (vector.size() != 0) {
+            std::cout << vector.size() << " items left after draining\n";
+            passed = false;
+        }
+
+        if (std::thread::hardware_concurrency() < 2) {
+            std::cout << "single core: no weak-memory coverage\n";
+        }
+        std::cout << threadCount << " threads, " << issued.size()
+                  << " handles issued over " << vector.capacity()
+                  << " slots: " << (passed ? "passed" : "FAILED") << '\n';
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
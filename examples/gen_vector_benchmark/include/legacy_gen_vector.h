@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+
+template <typename T>
+class LegacyGenerationVector {
+   public:
+    class Index {
+       private:
+        friend LegacyGenerationVector;
+
+        Index(size_t index_, size_t generation_)
+            : INDEX{index_}, GENERATION{generation_} {};
+        size_t INDEX;
+        size_t GENERATION;
+    };
+
+    LegacyGenerationVector(size_t capacity)
+        : next_free_entry{0}, generation{0}, num_items{0} {
+        items.resize(capacity);
+        for (size_t i{0}; i < items.size(); i++) {
+            items[i] = i + 1;
+        };
+        items.back() = std::numeric_limits<size_t>::max();
+    };
+
+    Index insert(const T& item) {
+        size_t free_entry = next_free_entry;
+        next_free_entry = std::get<size_t>(items[free_entry]);
+        if (next_free_entry == std::numeric_limits<size_t>::max()) {
+            throw std::length_error("LegacyGenerationVector cannot grow");
+        }
+        items[free_entry] = Entry{item, generation};
+        num_items++;
+        return Index{free_entry, generation};
+    }
+
+    void remove(const Index& index) {
+        items[index.INDEX] = next_free_entry;
+        next_free_entry = index.INDEX;
+        num_items--, generation++;
+    };
+
+    T const& get(Index index) {
+        Entry& entry{std::get<Entry>(items[index.INDEX])};
+        if (entry.generation != index.GENERATION) {
+            throw std::logic_error{"Invalid index generation"};
+        }
+        return entry.item;
+    }
+
+    size_t size() { return num_items; }
+
+   private:
+    struct Entry {
+        Entry(const T& item_, size_t generation_)
+            : item{item_}, generation{generation_} {};
+        T item;
+        size_t generation;
+    };
+    std::vector<std::variant<size_t, Entry>> items;
+    size_t next_free_entry;
+    size_t generation;
+    size_t num_items;
+};
@@ -0,0 +1,137 @@
+#include <rupture/ecs/gen_vector.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "legacy_gen_vector.h"
+
+const size_t ITEM_COUNT = 1000000;
+const size_t CHURN_COUNT = ITEM_COUNT / 2;
+const size_t RUN_COUNT = 5;
+
+struct Item {
+    uint64_t a;
+    uint64_t b;
+};
+
+struct Timings {
+    double insert{0.0};
+    double remove{0.0};
+    double reinsert{0.0};
+    double get{0.0};
+    double iterate{0.0};
+    uint64_t checksum{0};
+};
+
+template <typename Func>
+double measure(Func&& func) {
+    auto begin = std::chrono::steady_clock::now();
+    func();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+template <typename Vector, typename Make, typename Iterate>
+Timings run(Make&& make, Iterate&& iterate) {
+    std::mt19937 random{42};
+    std::vector<size_t> order(ITEM_COUNT);
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random);
+
+    Timings timings{};
+    std::optional<Vector> vector{};
+    std::vector<typename Vector::Index> handles{};
+    handles.reserve(ITEM_COUNT);
+
+    timings.insert = measure([&]() {
+        vector.emplace(make());
+        for (size_t i{0}; i < ITEM_COUNT; i++) {
+            handles.push_back(vector->insert(Item{i, i * 3}));
+        }
+    });
+
+    timings.remove = measure([&]() {
+        for (size_t i{0}; i < CHURN_COUNT; i++) {
+            vector->remove(handles[order[i]]);
+        }
+    });
+
+    timings.reinsert = measure([&]() {
+        for (size_t i{0}; i < CHURN_COUNT; i++) {
+            handles[order[i]] = vector->insert(Item{i, i});
+        }
+    });
+
+    timings.get = measure([&]() {
+        for (auto i : order) {
+            timings.checksum += vector->get(handles[i]).a;
+        }
+    });
+
+    timings.iterate = measure([&]() { timings.checksum += iterate(*vector); });
+    return timings;
+}
+
+template <typename Vector, typename Make, typename Iterate>
+Timings best(Make&& make, Iterate&& iterate) {
+    auto result = run<Vector>(make, iterate);
+    for (size_t i{1}; i < RUN_COUNT; i++) {
+        auto timings = run<Vector>(make, iterate);
+        result.insert = std::min(result.insert, timings.insert);
+        result.remove = std::min(result.remove, timings.remove);
+        result.reinsert = std::min(result.reinsert, timings.reinsert);
+        result.get = std::min(result.get, timings.get);
+        result.iterate = std::min(result.iterate, timings.iterate);
+        result.checksum += timings.checksum;
+    }
+    return result;
+}
+
+void print(const char* name, const Timings& timings, bool iterates) {
+    std::cout << std::setw(8) << name << ": insert " << timings.insert
+              << " ms, remove " << timings.remove << " ms, reinsert "
+              << timings.reinsert << " ms, get "
+              << timings.get << " ms";
+    if (iterates) {
+        std::cout << ", iterate " << timings.iterate << " ms";
+    }
+    std::cout << " (checksum " << timings.checksum << ")\n";
+}
+
+int main() {
+    try {
+        std::cout << std::fixed << std::setprecision(2) << ITEM_COUNT
+                  << " items, " << CHURN_COUNT << " churned, best of "
+                  << RUN_COUNT << " runs\n";
+
+        using Legacy = LegacyGenerationVector<Item>;
+        auto legacy = best<Legacy>(
+            []() { return Legacy{ITEM_COUNT + 1}; },
+            [](Legacy&) { return uint64_t{0}; });
+        print("legacy", legacy, false);
+
+        using Chunked = GenerationVector<Item>;
+        auto chunked = best<Chunked>([]() { return Chunked{}; },
+                                     [](Chunked& vector) {
+                                         uint64_t sum{0};
+                                         vector.forEach([&](const Item& item) {
+                                             sum += item.b;
+                                         });
+                                         return sum;
+                                     });
+        print("chunked", chunked, true);
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <rupture/application.h>
+#include <rupture/graphics/gl/storage_buffer.h>
+#include <rupture/graphics/gltf/crowd.h>
+#include <rupture/graphics/palette_ring.h>
 
 #include <string>
+#include <vector>
 
 class Demo : public Application {
    public:
@@ -28,9 +32,20 @@ class Demo : public Application {
     double m_animDebugStep{0.005};
     double m_elapsedTime{0};
     gltf::Document m_document;
-    gl::std140::Block<std::array<glm::mat4, 20>> m_jointBlock;
-    std::vector<glm::mat4> m_jointMatrices;
-    gl::ShaderUniform m_jointUniform{"JointMatrices"};
+    gltf::CrowdAnimator m_crowd;
+    PaletteRing m_paletteRing{paletteCapacity};
+    gl::StorageBuffer m_jointPalettes{
+        m_paletteRing.capacity() * sizeof(glm::mat4),
+        m_paletteRing.regionCount()};
+    std::vector<SkinInstance> m_instances;
+    ThreadPool* m_threadPool{nullptr};
+    gl::Window* m_window{nullptr};
 
     constexpr static uint32_t animationIndex{0};
+    constexpr static size_t crowdRows{8};
+    constexpr static size_t crowdColumns{8};
+    constexpr static float crowdSpacing{1.5f};
+    constexpr static double crowdTimeStep{0.13};
+    constexpr static size_t paletteCapacity{4096};
+    constexpr static GLuint jointPaletteBinding{0};
 };
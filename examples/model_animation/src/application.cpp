@@ -3,6 +3,9 @@
 #include <rupture/graphics/assets/assets.h>
 #include <rupture/graphics/shaders/shaders.h>
 
+#include <cmath>
+#include <limits>
+
 Demo::Demo(const std::string& title, uint32_t window_width,
            uint32_t window_height)
     : Application{title, window_width, window_height},
@@ -13,12 +16,18 @@ void Demo::loadResources(gl::Context& context) {
     m_shader = context.loadShader(shader::animated::DIFFUSE);
     m_skinModel = context.getModel<SkinVertex>("CesiumMan.Cesium_Man");
     m_environment = context.createEnvironmentMap(assets::env_map::NEWPORT_LOFT);
+    m_threadPool = &context.threadPool();
 
     const auto& skin = m_document.at<gltf::Skin>()[0];
     m_animationDuration = skin.animationDuration(animationIndex);
+    m_crowd.setLodLevels({{8.0f, 1, false},
+                          {16.0f, 2, false},
+                          {32.0f, 4, true},
+                          {std::numeric_limits<float>::max(), 8, true}});
 }
 
 void Demo::setupInputCallbacks(gl::Window& window) {
+    m_window = &window;
     m_camera = window.addCamera<TopViewCamera>(window, false);
     window.setActiveCamera(m_camera);
     window.registerKeyEventCallback(
@@ -65,9 +74,11 @@ void Demo::setupInputCallbacks(gl::Window& window) {
 void Demo::draw(gl::Context& context, double dTime) {
     context.setEnvironment(m_environment);
     context.setLighting(m_lightPack);
-    context.setShaderState(m_shader).bindUniformBlock(
-        m_jointUniform.blockInfo());
-    context.drawDeferred(m_skinModel, glm::identity<glm::mat4>());
+    context.setShaderState(m_shader);
+    m_jointPalettes.bind(jointPaletteBinding);
+    for (const auto& instance : m_instances) {
+        context.drawDeferred(m_skinModel, instance);
+    }
 }
 
 void Demo::update(double dTime) {
@@ -77,11 +88,34 @@ void Demo::update(double dTime) {
     m_elapsedTime -=
         static_cast<uint32_t>(m_elapsedTime / m_animationDuration) *
         m_animationDuration;
+    m_jointPalettes.fence(m_paletteRing.region());
+    m_jointPalettes.wait(m_paletteRing.beginFrame());
+
     const auto& skin = m_document.at<gltf::Skin>()[0];
-    auto jointMatrices = skin.jointMatrices(glm::identity<glm::mat4>(),
-                                            animationIndex, m_elapsedTime);
-    for (size_t index = 0; index < jointMatrices.size(); ++index) {
-        m_jointBlock.value.at(index) = jointMatrices[index];
+    auto camera = m_window->getCameraPosition();
+    m_crowd.clear();
+    m_instances.clear();
+    for (size_t row{0}; row < crowdRows; row++) {
+        for (size_t column{0}; column < crowdColumns; column++) {
+            auto index = row * crowdColumns + column;
+            auto time = std::fmod(m_elapsedTime + index * crowdTimeStep,
+                                  m_animationDuration);
+            glm::vec3 position{
+                (column - (crowdColumns - 1) / 2.0f) * crowdSpacing, 0.0f,
+                (row - (crowdRows - 1) / 2.0f) * crowdSpacing};
+            auto offset = m_crowd.add(skin, animationIndex, time,
+                                      glm::identity<glm::mat4>(),
+                                      glm::distance(camera, position));
+            m_instances.push_back(SkinInstance{
+                glm::translate(glm::identity<glm::mat4>(), position),
+                static_cast<uint32_t>(offset)});
+        }
+    }
+
+    auto base = m_paletteRing.allocate(m_crowd.paletteSize());
+    m_crowd.update(*m_threadPool, m_jointPalettes.data<glm::mat4>() + base,
+                   m_crowd.paletteSize());
+    for (auto& instance : m_instances) {
+        instance.paletteOffset += static_cast<uint32_t>(base);
     }
-    m_jointUniform.write(m_jointBlock);
 }
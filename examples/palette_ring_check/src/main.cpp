@@ -0,0 +1,237 @@
+#include <rupture/graphics/gltf/crowd.h>
+#include <rupture/graphics/gltf/document.h>
+#include <rupture/graphics/palette_ring.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+const uint32_t JOINT_COUNT = 12;
+const uint32_t KEY_COUNT = 8;
+const float KEY_INTERVAL = 0.25f;
+const size_t INSTANCE_COUNT = 16;
+const size_t FRAME_COUNT = 6;
+const float TOLERANCE = 1e-5f;
+
+class Checks {
+   public:
+    void operator()(bool passed, const std::string& message) {
+        if (!passed) {
+            m_errors.push_back(message);
+        }
+    }
+
+    int report() const {
+        for (const auto& error : m_errors) {
+            std::cout << error << '\n';
+        }
+        std::cout << (m_errors.empty() ? "passed" : "FAILED") << '\n';
+        return m_errors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+   private:
+    std::vector<std::string> m_errors;
+};
+
+template <typename Func>
+bool throws(Func&& func) {
+    try {
+        func();
+    } catch (std::out_of_range&) {
+        return true;
+    }
+    return false;
+}
+
+void checkRing(Checks& check) {
+    PaletteRing ring{100};
+    check(ring.capacity() == 300 && ring.regionCount() == 3,
+          "default ring does not have three regions");
+
+    std::vector<size_t> regions{};
+    for (size_t i{0}; i < 7; i++) {
+        regions.push_back(ring.beginFrame());
+    }
+    check(regions == std::vector<size_t>{1, 2, 0, 1, 2, 0, 1},
+          "regions do not cycle in order");
+
+    ring.beginFrame();
+    auto first = ring.allocate(60);
+    auto second = ring.allocate(40);
+    check(first == 200 && second == 260 && ring.used() == 100,
+          "allocations are not packed into the current region");
+    check(throws([&ring]() { ring.allocate(1); }),
+          "allocating past the region does not throw");
+
+    ring.beginFrame();
+    check(ring.allocate(1) == 0, "a new frame does not restart the region");
+}
+
+uint32_t addAccessor(fx::gltf::Document& document, const void* data,
+                     uint32_t count, size_t elementSize,
+                     fx::gltf::Accessor::Type type) {
+    auto& buffer = document.buffers[0];
+    auto offset = buffer.data.size();
+    buffer.data.resize(offset + count * elementSize);
+    std::memcpy(&buffer.data[offset], data, count * elementSize);
+    buffer.byteLength = static_cast<uint32_t>(buffer.data.size());
+
+    fx::gltf::BufferView view{};
+    view.buffer = 0;
+    view.byteOffset = static_cast<uint32_t>(offset);
+    view.byteLength = static_cast<uint32_t>(count * elementSize);
+    document.bufferViews.push_back(view);
+
+    fx::gltf::Accessor accessor{};
+    accessor.bufferView =
+        static_cast<int32_t>(document.bufferViews.size() - 1);
+    accessor.count = count;
+    accessor.componentType = fx::gltf::Accessor::ComponentType::Float;
+    accessor.type = type;
+    document.accessors.push_back(accessor);
+    return static_cast<uint32_t>(document.accessors.size() - 1);
+}
+
+fx::gltf::Document makeDocument() {
+    fx::gltf::Document document{};
+    document.buffers.emplace_back();
+    document.nodes.resize(JOINT_COUNT + 1);
+    document.nodes[0].name = "armature";
+    document.nodes[0].children.push_back(1);
+    fx::gltf::Skin skin{};
+    std::vector<glm::mat4> inverseBinds{};
+    for (uint32_t i{1}; i <= JOINT_COUNT; i++) {
+        document.nodes[i].name = "joint" + std::to_string(i);
+        document.nodes[i].translation = {0.0f, 1.0f, 0.0f};
+        if (i < JOINT_COUNT) {
+            document.nodes[i].children.push_back(static_cast<int32_t>(i + 1));
+        }
+        skin.joints.push_back(i);
+        inverseBinds.push_back(glm::translate(
+            glm::mat4{1.0f}, glm::vec3{0.0f, -static_cast<float>(i), 0.0f}));
+    }
+    skin.skeleton = 1;
+    skin.inverseBindMatrices =
+        addAccessor(document, inverseBinds.data(), JOINT_COUNT,
+                    sizeof(glm::mat4), fx::gltf::Accessor::Type::Mat4);
+    document.skins.push_back(skin);
+
+    std::vector<float> times(KEY_COUNT);
+    for (uint32_t k{0}; k < KEY_COUNT; k++) {
+        times[k] = k * KEY_INTERVAL;
+    }
+    auto input = addAccessor(document, times.data(), KEY_COUNT, sizeof(float),
+                             fx::gltf::Accessor::Type::Scalar);
+
+    fx::gltf::Animation animation{};
+    animation.name = "wave";
+    for (uint32_t i{1}; i <= JOINT_COUNT; i++) {
+        std::vector<glm::quat> rotations(KEY_COUNT);
+        for (uint32_t k{0}; k < KEY_COUNT; k++) {
+            auto angle = std::sin(0.7f * k + 0.3f * i);
+            rotations[k] = glm::angleAxis(
+                angle, glm::normalize(glm::vec3{1.0f, 0.2f * i, 0.5f}));
+        }
+        fx::gltf::Animation::Sampler sampler{};
+        sampler.input = input;
+        sampler.output =
+            addAccessor(document, rotations.data(), KEY_COUNT,
+                        sizeof(glm::quat), fx::gltf::Accessor::Type::Vec4);
+        animation.samplers.push_back(sampler);
+
+        fx::gltf::Animation::Channel channel{};
+        channel.sampler = static_cast<int32_t>(animation.samplers.size() - 1);
+        channel.target.node = static_cast<int32_t>(i);
+        channel.target.path = "rotation";
+        animation.channels.push_back(channel);
+    }
+    document.animations.push_back(animation);
+    return document;
+}
+
+float maxDifference(const glm::mat4& lhs, const glm::mat4& rhs) {
+    float difference{0.0f};
+    for (int c{0}; c < 4; c++) {
+        for (int r{0}; r < 4; r++) {
+            difference = std::max(difference, std::abs(lhs[c][r] - rhs[c][r]));
+        }
+    }
+    return difference;
+}
+
+void checkCrowd(Checks& check, const gltf::Skin& skin, ThreadPool& pool) {
+    gltf::CrowdAnimator crowd{4};
+    PaletteRing ring{skin.jointCount() * INSTANCE_COUNT};
+    std::vector<glm::mat4> buffer(ring.capacity(), glm::mat4{0.0f});
+    auto duration = static_cast<float>(skin.animationDuration(0));
+
+    std::set<size_t> bases{};
+    float error{0.0f};
+    for (size_t frame{0}; frame < FRAME_COUNT; frame++) {
+        ring.beginFrame();
+        crowd.clear();
+        std::vector<size_t> offsets{};
+        for (size_t i{0}; i < INSTANCE_COUNT; i++) {
+            auto time = std::fmod(0.1f * i + 0.05f * frame, duration);
+            auto root = glm::translate(glm::mat4{1.0f},
+                                       glm::vec3{static_cast<float>(i), 0, 0});
+            offsets.push_back(crowd.add(skin, 0, time, root));
+        }
+        check(crowd.paletteSize() == skin.jointCount() * INSTANCE_COUNT,
+              "crowd palette size does not cover every joint");
+
+        auto base = ring.allocate(crowd.paletteSize());
+        bases.insert(base);
+        crowd.update(pool, buffer.data() + base, crowd.paletteSize());
+        for (size_t i{0}; i < INSTANCE_COUNT; i++) {
+            check(offsets[i] == crowd.paletteOffset(i) &&
+                      offsets[i] == i * skin.jointCount(),
+                  "crowd offsets are not packed back to back");
+            auto time = std::fmod(0.1f * i + 0.05f * frame, duration);
+            auto root = glm::translate(glm::mat4{1.0f},
+                                       glm::vec3{static_cast<float>(i), 0, 0});
+            auto expected = skin.jointMatrices(root, 0, time);
+            const auto* palette = buffer.data() + base + offsets[i];
+            for (size_t j{0}; j < expected.size(); j++) {
+                error = std::max(error, maxDifference(expected[j], palette[j]));
+            }
+        }
+    }
+    check(bases.size() == ring.regionCount(),
+          "crowd frames did not rotate through every region");
+    check(error < TOLERANCE, "crowd palettes differ from jointMatrices by " +
+                                 std::to_string(error));
+    check(throws([&]() {
+              crowd.update(pool, buffer.data(), crowd.paletteSize() - 1);
+          }),
+          "updating into a short palette buffer does not throw");
+}
+
+int main() {
+    try {
+        Checks check{};
+        checkRing(check);
+
+        auto path = std::filesystem::temp_directory_path() /
+                    "palette_ring_check.glb";
+        fx::gltf::Save(makeDocument(), path, true);
+        gltf::Document document{path};
+        std::filesystem::remove(path);
+        ThreadPool pool{};
+        checkCrowd(check, document.at<gltf::Skin>().at(0), pool);
+        return check.report();
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
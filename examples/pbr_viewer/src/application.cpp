@@ -12,7 +12,8 @@ void Demo::loadResources(gl::Context& context) {
     m_shaders.emplace_back(
         context.getShader(shader::nameOf(shader::pbr::COOK_TORRANCE)));
 
-    gltf::Document waterBottle{"assets/WaterBottle/glTF/WaterBottle.gltf"s};
+    gltf::Document waterBottle{"assets/WaterBottle/glTF/WaterBottle.gltf"s,
+                               context.threadPool()};
     context.loadDocument(waterBottle);
 
     m_rigidModels.emplace_back(
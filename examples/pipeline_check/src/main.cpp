@@ -0,0 +1,117 @@
+#include <rupture/graphics/gl/pipeline.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <type_traits>
+
+template <typename View, typename T>
+constexpr bool isConst() {
+    return std::is_const_v<
+        std::remove_reference_t<decltype(std::declval<View&>()
+                                             .template get<T>())>>;
+}
+
+class Seed : public PipelineStage<int32_t> {
+   public:
+    static constexpr bool ContextThread = false;
+
+   protected:
+    void execute(ResourceView&& resources) override {
+        resources.get<int32_t>() = 20;
+    }
+};
+
+class Scale : public FusableStage<Scale, Read<int32_t>, Write<int64_t>> {
+   public:
+    static constexpr bool ContextThread = false;
+
+    template <typename View>
+    void process(View& resources) {
+        static_assert(isConst<View, int32_t>() && !isConst<View, int64_t>());
+        resources.template get<int64_t>() = resources.template get<int32_t>();
+        resources.template get<int64_t>() *= 2;
+    }
+};
+
+class Scratch : public FusableStage<Scratch, Read<int64_t>, Write<int16_t>> {
+   public:
+    static constexpr bool ContextThread = false;
+
+    template <typename View>
+    void process(View& resources) {
+        static_assert(isConst<View, int64_t>() && !isConst<View, int16_t>());
+        resources.template get<int16_t>() +=
+            static_cast<int16_t>(resources.template get<int64_t>());
+    }
+};
+
+class Combine
+    : public FusableStage<Combine, Read<int32_t, int64_t>, Write<uint32_t>> {
+   public:
+    static constexpr bool ContextThread = false;
+
+    template <typename View>
+    void process(View& resources) {
+        static_assert(isConst<View, int64_t>() && !isConst<View, uint32_t>());
+        resources.template get<uint32_t>() = static_cast<uint32_t>(
+            resources.template get<int32_t>() +
+            resources.template get<int64_t>());
+    }
+};
+
+class Collect : public PipelineStage<Read<uint32_t>, Write<uint64_t>> {
+   protected:
+    void execute(ResourceView&& resources) override {
+        resources.get<uint64_t>() += resources.get<uint32_t>();
+        total += resources.get<uint32_t>();
+    }
+
+   public:
+    static inline uint64_t total{0};
+};
+
+using FusedPipeline = Pipeline<Seed, Scale, Scratch, Combine, Collect>;
+
+static_assert(
+    std::is_same_v<FusedPipeline::Layout,
+                   TypeList<TypeList<Seed>, TypeList<Scale, Scratch, Combine>,
+                            TypeList<Collect>>>,
+    "Adjacent fusable worker stages form one group");
+static_assert(std::is_same_v<FusedPipeline::DeadResources,
+                             TypeList<int16_t, uint64_t>>,
+              "Resources touched by a single writer are dead");
+template <typename T>
+constexpr bool isLive() {
+    return ListContainsType<T, FusedPipeline::LiveResources>::value;
+}
+
+static_assert(isLive<int32_t>() && isLive<int64_t>() && isLive<uint32_t>() &&
+                  FusedPipeline::LiveResources::size == 3,
+              "Shared resources stay in pipeline storage");
+static_assert(FusedPipeline::GroupDependencies[0] == 0 &&
+                  FusedPipeline::GroupDependencies[1] == 1 &&
+                  FusedPipeline::GroupDependencies[2] == 2,
+              "Groups run in declaration order");
+
+int main() {
+    try {
+        FusedPipeline serial{};
+        for (size_t i{0}; i < 3; i++) {
+            serial.execute();
+        }
+        ThreadPool pool{};
+        FusedPipeline threaded{};
+        for (size_t i{0}; i < 3; i++) {
+            threaded.execute(pool);
+        }
+        auto passed = Collect::total == 6 * 60;
+        std::cout << "collected " << Collect::total << ": "
+                  << (passed ? "passed" : "FAILED") << '\n';
+        return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
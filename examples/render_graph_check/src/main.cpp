@@ -0,0 +1,178 @@
+#include <rupture/graphics/gl/pipeline.h>
+#include <rupture/graphics/gl/render_graph.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+struct Albedo {};
+struct Normal {};
+struct Depth {};
+struct Lighting {};
+struct Debug {};
+struct Bloom {};
+struct Output {};
+struct Particles {};
+
+class GBufferStage
+    : public PipelineStage<Read<>, Write<Albedo, Normal, Depth>> {
+   public:
+    static constexpr const char* Name = "gbuffer";
+
+   protected:
+    void execute(ResourceView&&) override {}
+};
+
+class DebugStage : public PipelineStage<Read<Albedo>, Write<Debug>> {
+   protected:
+    void execute(ResourceView&&) override {}
+};
+
+class LightingStage
+    : public PipelineStage<Read<Albedo, Normal, Depth>, Write<Lighting>> {
+   protected:
+    void execute(ResourceView&&) override {}
+};
+
+class BloomStage : public PipelineStage<Read<Lighting>, Write<Bloom>> {
+   protected:
+    void execute(ResourceView&&) override {}
+};
+
+class ToneMapStage
+    : public PipelineStage<Read<Bloom, Lighting, Particles, float>,
+                           Write<Output>> {
+   protected:
+    void execute(ResourceView&&) override {}
+};
+
+class Checks {
+   public:
+    void operator()(bool passed, const std::string& message) {
+        if (!passed) {
+            m_errors.push_back(message);
+        }
+    }
+
+    int report() const {
+        for (const auto& error : m_errors) {
+            std::cout << error << '\n';
+        }
+        std::cout << (m_errors.empty() ? "passed" : "FAILED") << '\n';
+        return m_errors.empty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+   private:
+    std::vector<std::string> m_errors;
+};
+
+void checkStages(Checks& check) {
+    using Access = gl::RenderGraph::Access;
+    gl::RenderGraph graph{};
+    gl::TextureDesc color{GL_RGBA8, 640, 480, 1};
+    gl::TextureDesc depth{GL_DEPTH_COMPONENT32F, 640, 480, 1};
+
+    auto albedo = graph.createTexture("albedo", color);
+    auto normal = graph.createTexture("normal", color);
+    auto z = graph.createTexture("depth", depth);
+    auto lighting = graph.createTexture("lighting", color);
+    auto debug = graph.createTexture("debug", color);
+    auto bloom = graph.createTexture("bloom", color);
+    auto output = graph.createTexture("output", color);
+    auto particles = graph.importBuffer("particles", 1);
+    graph.bind<Albedo>(albedo);
+    graph.bind<Normal>(normal);
+    graph.bind<Depth>(z);
+    graph.bind<Lighting>(lighting, Access::Sampled, Access::Image);
+    graph.bind<Debug>(debug);
+    graph.bind<Bloom>(bloom, Access::Image, Access::Image);
+    graph.bind<Output>(output);
+    graph.bind<Particles>(particles);
+    graph.markOutput(output);
+
+    auto gbufferPass = graph.addStage<GBufferStage>(nullptr);
+    auto debugPass = graph.addStage<DebugStage>(nullptr);
+    auto lightingPass = graph.addStage<LightingStage>(nullptr);
+    auto bloomPass = graph.addStage<BloomStage>(nullptr);
+    auto toneMapPass = graph.addStage<ToneMapStage>(nullptr);
+    graph.compile();
+
+    check(!graph.culled(gbufferPass) && !graph.culled(lightingPass) &&
+              !graph.culled(bloomPass) && !graph.culled(toneMapPass),
+          "stage passes feeding the output were culled");
+    check(graph.culled(debugPass), "unread debug stage was not culled");
+    check(graph.physicalIndex(debug) == std::numeric_limits<uint32_t>::max(),
+          "culled stage output was given a texture");
+
+    check(graph.lifetime(albedo).first == 0 &&
+              graph.lifetime(albedo).last == 2,
+          "albedo lifetime does not span gbuffer to lighting");
+    check(graph.lifetime(output).last == 5,
+          "output lifetime does not reach the end of the frame");
+    check(graph.physicalIndex(bloom) == graph.physicalIndex(albedo),
+          "bloom does not alias the dead albedo target");
+    check(graph.physicalIndex(output) == graph.physicalIndex(normal),
+          "output does not alias the dead normal target");
+    check(graph.physicalIndex(z) != graph.physicalIndex(lighting),
+          "depth aliases a colour target");
+    check(graph.physicalCount() == 4, "expected four physical textures");
+    check(graph.lifetime(particles).first == 4,
+          "bound buffer was not derived from the tone map reads");
+
+    check(graph.barriers(gbufferPass) == 0 &&
+              graph.barriers(lightingPass) == 0,
+          "attachment-only passes got barriers");
+    check(graph.barriers(bloomPass) == GL_TEXTURE_FETCH_BARRIER_BIT,
+          "bloom does not fence the image store to lighting");
+    check(graph.barriers(toneMapPass) == GL_SHADER_IMAGE_ACCESS_BARRIER_BIT,
+          "tone map does not fence the image store to bloom");
+}
+
+void checkOverwrite(Checks& check) {
+    gl::RenderGraph graph{};
+    auto target = graph.createTexture("target", {GL_RGBA8, 64, 64, 1});
+    auto first = graph.addPass(
+        "first", [&](auto& builder) { builder.write(target); }, nullptr);
+    auto second = graph.addPass(
+        "second", [&](auto& builder) { builder.write(target); }, nullptr);
+    auto present = graph.addPass(
+        "present",
+        [&](auto& builder) { builder.read(target).sideEffect(); }, nullptr);
+    graph.compile();
+    check(graph.culled(first), "overwritten write was not culled");
+    check(!graph.culled(second) && !graph.culled(present),
+          "side effect pass or its input was culled");
+}
+
+void checkBufferAccess(Checks& check) {
+    gl::RenderGraph graph{};
+    auto buffer = graph.importBuffer("buffer", 1);
+    check(graph.kind(buffer) == gl::RenderGraph::Kind::Buffer,
+          "imported buffer is not a buffer");
+    auto rejected = false;
+    try {
+        graph.addPass(
+            "sampled", [&](auto& builder) { builder.read(buffer); }, nullptr);
+    } catch (std::logic_error&) {
+        rejected = true;
+    }
+    check(rejected, "sampled buffer read was accepted");
+}
+
+int main() {
+    try {
+        Checks check{};
+        checkStages(check);
+        checkOverwrite(check);
+        checkBufferAccess(check);
+        return check.report();
+    } catch (std::exception& e) {
+        std::cout << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+const size_t DEFAULT_ARENA_BLOCK_SIZE = 64 * 1024;
+
+class LinearArena {
+   public:
+    explicit LinearArena(size_t blockSize = DEFAULT_ARENA_BLOCK_SIZE)
+        : m_blockSize{blockSize} {}
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena(LinearArena&&) = default;
+
+    LinearArena& operator=(const LinearArena&) = delete;
+    LinearArena& operator=(LinearArena&&) = default;
+
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        while (m_block < m_blocks.size()) {
+            auto& block = m_blocks[m_block];
+            auto base = reinterpret_cast<uintptr_t>(block.data.get());
+            auto offset = align(base + m_offset, alignment) - base;
+            if (offset + size <= block.size) {
+                m_offset = offset + size;
+                m_used += size;
+                return block.data.get() + offset;
+            }
+            m_block++;
+            m_offset = 0;
+        }
+        auto blockSize = std::max(m_blockSize, size + alignment);
+        m_blocks.push_back(
+            Block{std::make_unique<std::byte[]>(blockSize), blockSize});
+        m_block = m_blocks.size() - 1;
+        m_offset = 0;
+        return allocate(size, alignment);
+    }
+
+    template <typename T>
+    T* allocate(size_t count = 1) {
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+
+    void reset() {
+        m_block = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    size_t used() const { return m_used; }
+    size_t capacity() const {
+        size_t capacity{0};
+        for (const auto& block : m_blocks) {
+            capacity += block.size;
+        }
+        return capacity;
+    }
+
+   private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+
+    static uintptr_t align(uintptr_t address, size_t alignment) {
+        return (address + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    }
+
+    std::vector<Block> m_blocks;
+    size_t m_blockSize;
+    size_t m_block{0};
+    size_t m_offset{0};
+    size_t m_used{0};
+};
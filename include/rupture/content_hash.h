@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace content_hash {
+
+const uint64_t PRIME_1 = 0x9E3779B185EBCA87ull;
+const uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4Full;
+const uint64_t PRIME_3 = 0x165667B19E3779F9ull;
+const uint64_t PRIME_4 = 0x85EBCA77C2B2AE63ull;
+const uint64_t PRIME_5 = 0x27D4EB2F165667C5ull;
+
+inline uint64_t rotate(uint64_t value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline uint64_t load(const uint8_t* data) {
+    uint64_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint64_t round(uint64_t lane, uint64_t input) {
+    return rotate(lane + input * PRIME_2, 31) * PRIME_1;
+}
+
+inline uint64_t merge(uint64_t hash, uint64_t lane) {
+    return (hash ^ round(0, lane)) * PRIME_1 + PRIME_4;
+}
+
+}  // namespace content_hash
+
+inline uint64_t contentHash(const void* data, size_t size, uint64_t seed = 0) {
+    using namespace content_hash;
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    const auto* end = bytes + size;
+
+    uint64_t hash;
+    if (size >= 32) {
+        uint64_t lanes[4]{seed + PRIME_1 + PRIME_2, seed + PRIME_2, seed,
+                          seed - PRIME_1};
+        for (; bytes + 32 <= end; bytes += 32) {
+            for (size_t i{0}; i < 4; i++) {
+                lanes[i] = round(lanes[i], load(bytes + i * 8));
+            }
+        }
+        hash = rotate(lanes[0], 1) + rotate(lanes[1], 7) +
+               rotate(lanes[2], 12) + rotate(lanes[3], 18);
+        for (auto lane : lanes) {
+            hash = merge(hash, lane);
+        }
+    } else {
+        hash = seed + PRIME_5;
+    }
+    hash += size;
+
+    for (; bytes + 8 <= end; bytes += 8) {
+        hash = rotate(hash ^ round(0, load(bytes)), 27) * PRIME_1 + PRIME_4;
+    }
+    for (; bytes < end; bytes++) {
+        hash = rotate(hash ^ (*bytes * PRIME_5), 11) * PRIME_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME_2;
+    hash ^= hash >> 29;
+    hash *= PRIME_3;
+    hash ^= hash >> 32;
+    return hash;
+}
@@ -1,54 +1,137 @@
 #pragma once
 
-#include <any>
-#include <iostream>
-#include <memory>
-#include <typeindex>
-#include <typeinfo>
-#include <unordered_map>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "rupture/arena.h"
+
+class TypeId {
+   public:
+    template <typename T>
+    static size_t of() {
+        static const size_t id{next().fetch_add(1, std::memory_order_relaxed)};
+        return id;
+    }
+
+   private:
+    static std::atomic<size_t>& next() {
+        static std::atomic<size_t> counter{0};
+        return counter;
+    }
+};
 
 class AnyMap {
    public:
+    AnyMap() = default;
+
+    AnyMap(const AnyMap&) = delete;
+    AnyMap(AnyMap&&) = default;
+
+    AnyMap& operator=(const AnyMap&) = delete;
+    AnyMap& operator=(AnyMap&& other) {
+        if (this != &other) {
+            clear();
+            m_entries = std::move(other.m_entries);
+            m_arena = std::move(other.m_arena);
+        }
+        return *this;
+    }
+
+    ~AnyMap() { clear(); }
+
     template <typename T>
     bool insert(T item_) {
-        std::any item{std::make_shared<T>(std::move(item_))};
-        auto [_, inserted] =
-            map.insert({std::type_index(typeid(T)), std::move(item)});
-        return inserted;
+        auto& entry = entryFor<T>();
+        if (entry.alive) {
+            return false;
+        }
+        if (!entry.object) {
+            entry.object = m_arena.allocate(sizeof(T), alignof(T));
+            entry.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+        }
+        new (entry.object) T(std::move(item_));
+        entry.alive = true;
+        return true;
     };
 
     template <typename T>
     bool erase() {
-        auto node = map.extract(std::type_index(typeid(T)));
-        return node.empty();
+        auto id = TypeId::of<T>();
+        if (id >= m_entries.size() || !m_entries[id].alive) {
+            return false;
+        }
+        auto& entry = m_entries[id];
+        entry.destroy(entry.object);
+        entry.alive = false;
+        return true;
     };
 
+    template <typename T>
+    bool contains() const {
+        auto id = TypeId::of<T>();
+        return id < m_entries.size() && m_entries[id].alive;
+    }
+
     template <typename T>
     T const& get() const {
-        return *std::any_cast<const std::shared_ptr<T>&>(
-            map.at(std::type_index(typeid(T))));
+        auto item = try_get<T>();
+        if (!item) {
+            throw std::out_of_range("Resource not present in AnyMap");
+        }
+        return *item;
     };
 
     template <typename T>
     T& get_mut() {
-        return *std::any_cast<std::shared_ptr<T>&>(
-            map.at(std::type_index(typeid(T))));
+        auto item = try_get_mut<T>();
+        if (!item) {
+            throw std::out_of_range("Resource not present in AnyMap");
+        }
+        return *item;
     };
 
     template <typename T>
-    const std::shared_ptr<const T> try_get() const {
-        auto at = map.find(std::type_index(typeid(T)));
-        if (at == map.end()) return nullptr;
-        return std::any_cast<std::shared_ptr<T>>(at->second);
+    const T* try_get() const {
+        auto id = TypeId::of<T>();
+        if (id >= m_entries.size() || !m_entries[id].alive) return nullptr;
+        return static_cast<const T*>(m_entries[id].object);
     };
 
     template <typename T>
-    std::shared_ptr<T> try_get_mut() {
-        auto at = map.find(std::type_index(typeid(T)));
-        if (at == map.end()) return nullptr;
-        return std::any_cast<std::shared_ptr<T>>(at->second);
+    T* try_get_mut() {
+        auto id = TypeId::of<T>();
+        if (id >= m_entries.size() || !m_entries[id].alive) return nullptr;
+        return static_cast<T*>(m_entries[id].object);
     };
 
    private:
-    std::unordered_map<std::type_index, std::any> map;
-};
\ No newline at end of file
+    struct Entry {
+        void* object{nullptr};
+        void (*destroy)(void*){nullptr};
+        bool alive{false};
+    };
+
+    template <typename T>
+    Entry& entryFor() {
+        auto id = TypeId::of<T>();
+        if (id >= m_entries.size()) {
+            m_entries.resize(id + 1);
+        }
+        return m_entries[id];
+    }
+
+    void clear() {
+        for (auto& entry : m_entries) {
+            if (entry.alive) {
+                entry.destroy(entry.object);
+                entry.alive = false;
+            }
+        }
+    }
+
+    std::vector<Entry> m_entries;
+    LinearArena m_arena{1024};
+};
@@ -0,0 +1,412 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rupture/ecs/gen_vector.h"
+
+template <typename C, typename Tuple>
+struct tuple_type_index;
+
+template <typename C>
+struct tuple_type_index<C, std::tuple<>> {
+    static constexpr size_t index = 0;
+};
+
+template <typename C, typename... Members>
+struct tuple_type_index<C, std::tuple<C, Members...>> {
+    static constexpr size_t index = 0;
+};
+
+template <typename C, typename F, typename... Members>
+struct tuple_type_index<C, std::tuple<F, Members...>> {
+    static constexpr size_t index =
+        1 + tuple_type_index<C, std::tuple<Members...>>::index;
+};
+
+template <typename... Components>
+class ArchetypeStorage {
+   public:
+    static_assert(sizeof...(Components) <= 64,
+                  "ArchetypeStorage supports up to 64 component types");
+
+    using Signature = uint64_t;
+
+    struct Location {
+        size_t archetype;
+        size_t row;
+    };
+
+    using EntityId = typename GenerationVector<Location>::Index;
+
+    template <typename C>
+    static constexpr size_t componentIndex() {
+        using Component = std::remove_const_t<C>;
+        static_assert((std::is_same_v<Component, Components> || ...),
+                      "Component not registered in ArchetypeStorage");
+        return tuple_type_index<Component, std::tuple<Components...>>::index;
+    }
+
+    template <typename... Cs>
+    static constexpr Signature signatureOf() {
+        return (Signature{0} | ... | (Signature{1} << componentIndex<Cs>()));
+    }
+
+    class Archetype {
+       public:
+        Archetype(Signature signature) : m_signature{signature} {
+            m_addEdges.fill(npos);
+            m_removeEdges.fill(npos);
+        }
+
+        Signature signature() const { return m_signature; }
+        size_t size() const { return m_entities.size(); }
+
+        const std::vector<EntityId>& entities() const { return m_entities; }
+
+        template <typename C>
+        std::vector<std::remove_const_t<C>>& column() {
+            return std::get<componentIndex<C>()>(m_columns);
+        }
+
+        template <typename C>
+        const std::vector<std::remove_const_t<C>>& column() const {
+            return std::get<componentIndex<C>()>(m_columns);
+        }
+
+        template <typename C>
+        bool has() const {
+            return m_signature & signatureOf<C>();
+        }
+
+       private:
+        friend ArchetypeStorage;
+
+        Signature m_signature;
+        std::vector<EntityId> m_entities;
+        std::tuple<std::vector<Components>...> m_columns;
+        std::array<size_t, sizeof...(Components)> m_addEdges;
+        std::array<size_t, sizeof...(Components)> m_removeEdges;
+    };
+
+    template <typename A, typename... Args>
+    class Query {
+       public:
+        using Item = std::tuple<A&, Args&...>;
+
+        class iterator {
+           public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = Item;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = Item;
+
+            Item operator*() const {
+                return Item{std::get<A*>(m_columns)[m_row],
+                            std::get<Args*>(m_columns)[m_row]...};
+            }
+
+            iterator& operator++() {
+                if (++m_row == m_rows) {
+                    m_current++;
+                    seek();
+                }
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator prev{*this};
+                ++(*this);
+                return prev;
+            }
+
+            bool operator==(const iterator& rhs) const {
+                return m_current == rhs.m_current && m_row == rhs.m_row;
+            }
+            bool operator!=(const iterator& rhs) const {
+                return !(*this == rhs);
+            }
+
+           private:
+            friend Query;
+
+            iterator(Archetype* const* current, Archetype* const* end)
+                : m_current{current}, m_end{end} {
+                seek();
+            }
+
+            void seek() {
+                m_row = 0;
+                for (; m_current != m_end; m_current++) {
+                    m_rows = (*m_current)->size();
+                    if (m_rows) {
+                        m_columns = std::tuple<A*, Args*...>{
+                            (*m_current)->template column<A>().data(),
+                            (*m_current)->template column<Args>().data()...};
+                        return;
+                    }
+                }
+            }
+
+            Archetype* const* m_current;
+            Archetype* const* m_end;
+            std::tuple<A*, Args*...> m_columns;
+            size_t m_row{0};
+            size_t m_rows{0};
+        };
+
+        iterator begin() const {
+            return iterator{m_archetypes.data(),
+                            m_archetypes.data() + m_archetypes.size()};
+        }
+        iterator end() const {
+            auto last = m_archetypes.data() + m_archetypes.size();
+            return iterator{last, last};
+        }
+
+        template <typename Func>
+        void forEach(Func&& func) const {
+            for (auto archetype : m_archetypes) {
+                auto* a = archetype->template column<A>().data();
+                std::tuple<Args*...> args{
+                    archetype->template column<Args>().data()...};
+                for (size_t row{0}; row < archetype->size(); row++) {
+                    func(a[row], std::get<Args*>(args)[row]...);
+                }
+            }
+        }
+
+        template <typename Func>
+        void forEachArchetype(Func&& func) const {
+            for (auto archetype : m_archetypes) {
+                func(*archetype);
+            }
+        }
+
+        size_t size() const {
+            size_t count{0};
+            for (auto archetype : m_archetypes) {
+                count += archetype->size();
+            }
+            return count;
+        }
+
+       private:
+        friend ArchetypeStorage;
+
+        Query(std::vector<Archetype*>&& archetypes)
+            : m_archetypes{std::move(archetypes)} {}
+
+        std::vector<Archetype*> m_archetypes;
+    };
+
+    ArchetypeStorage() { findOrCreateArchetype(0); }
+
+    ArchetypeStorage(const ArchetypeStorage&) = delete;
+    ArchetypeStorage(ArchetypeStorage&&) = default;
+
+    ArchetypeStorage& operator=(const ArchetypeStorage&) = delete;
+    ArchetypeStorage& operator=(ArchetypeStorage&&) = default;
+
+    template <typename... Cs>
+    EntityId spawn(Cs... components) {
+        constexpr Signature signature = signatureOf<Cs...>();
+        static_assert(sizeof...(Cs) == bitCount(signature),
+                      "Duplicate component types in spawn");
+        auto archetypeIndex = findOrCreateArchetype(signature);
+        auto& archetype = m_archetypes[archetypeIndex];
+
+        auto id =
+            m_locations.insert(Location{archetypeIndex, archetype.size()});
+        archetype.m_entities.push_back(id);
+        (archetype.template column<Cs>().push_back(std::move(components)), ...);
+        return id;
+    }
+
+    void despawn(EntityId id) {
+        auto location = m_locations.get(id);
+        eraseRow(m_archetypes[location.archetype], location.row);
+        m_locations.remove(id);
+    }
+
+    template <typename C>
+    void set(EntityId id, C component) {
+        auto location = m_locations.get(id);
+        auto& archetype = m_archetypes[location.archetype];
+        if (archetype.template has<C>()) {
+            archetype.template column<C>()[location.row] = std::move(component);
+            return;
+        }
+        auto target = edge<true>(location.archetype, componentIndex<C>());
+        moveEntity(id, location, target);
+        m_archetypes[target].template column<C>().push_back(
+            std::move(component));
+    }
+
+    template <typename C>
+    void remove(EntityId id) {
+        auto location = m_locations.get(id);
+        if (!m_archetypes[location.archetype].template has<C>()) {
+            return;
+        }
+        auto target = edge<false>(location.archetype, componentIndex<C>());
+        moveEntity(id, location, target);
+    }
+
+    template <typename C>
+    bool has(EntityId id) const {
+        return m_archetypes[m_locations.get(id).archetype].template has<C>();
+    }
+
+    template <typename C>
+    C* get(EntityId id) {
+        auto location = m_locations.get(id);
+        auto& archetype = m_archetypes[location.archetype];
+        if (!archetype.template has<C>()) {
+            return nullptr;
+        }
+        return &archetype.template column<C>()[location.row];
+    }
+
+    template <typename C>
+    const C* get(EntityId id) const {
+        auto location = m_locations.get(id);
+        const auto& archetype = m_archetypes[location.archetype];
+        if (!archetype.template has<C>()) {
+            return nullptr;
+        }
+        return &archetype.template column<C>()[location.row];
+    }
+
+    template <typename A, typename... Args>
+    Query<A, Args...> query() {
+        constexpr Signature signature = signatureOf<A, Args...>();
+        std::vector<Archetype*> matching{};
+        for (auto& archetype : m_archetypes) {
+            if ((archetype.m_signature & signature) == signature &&
+                archetype.size()) {
+                matching.push_back(&archetype);
+            }
+        }
+        return Query<A, Args...>{std::move(matching)};
+    }
+
+    size_t size() const { return m_locations.size(); }
+    size_t archetypeCount() const { return m_archetypes.size(); }
+
+   private:
+    template <typename>
+    friend class CommandBuffer;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    static constexpr size_t bitCount(Signature signature) {
+        size_t count{0};
+        for (; signature; signature &= signature - 1) count++;
+        return count;
+    }
+
+    EntityId spawnWith(Signature signature) {
+        auto archetypeIndex = findOrCreateArchetype(signature);
+        auto& archetype = m_archetypes[archetypeIndex];
+        auto id =
+            m_locations.insert(Location{archetypeIndex, archetype.size()});
+        archetype.m_entities.push_back(id);
+        return id;
+    }
+
+    template <typename C>
+    void initialize(EntityId id, C component) {
+        auto& archetype = m_archetypes[m_locations.get(id).archetype];
+        archetype.template column<C>().push_back(std::move(component));
+    }
+
+    size_t findOrCreateArchetype(Signature signature) {
+        auto at = m_archetypeMap.find(signature);
+        if (at != m_archetypeMap.end()) {
+            return at->second;
+        }
+        m_archetypes.emplace_back(signature);
+        m_archetypeMap.emplace(signature, m_archetypes.size() - 1);
+        return m_archetypes.size() - 1;
+    }
+
+    template <bool Add>
+    size_t edge(size_t archetypeIndex, size_t component) {
+        auto cached = edges<Add>(archetypeIndex)[component];
+        if (cached != npos) {
+            return cached;
+        }
+        auto signature = m_archetypes[archetypeIndex].m_signature;
+        signature = Add ? signature | (Signature{1} << component)
+                        : signature & ~(Signature{1} << component);
+        auto target = findOrCreateArchetype(signature);
+        edges<Add>(archetypeIndex)[component] = target;
+        return target;
+    }
+
+    template <bool Add>
+    std::array<size_t, sizeof...(Components)>& edges(size_t archetypeIndex) {
+        if constexpr (Add) {
+            return m_archetypes[archetypeIndex].m_addEdges;
+        } else {
+            return m_archetypes[archetypeIndex].m_removeEdges;
+        }
+    }
+
+    void moveEntity(EntityId id, Location location, size_t targetIndex) {
+        auto& source = m_archetypes[location.archetype];
+        auto& target = m_archetypes[targetIndex];
+        auto shared = source.m_signature & target.m_signature;
+        (moveComponent<Components>(source, target, location.row, shared), ...);
+
+        size_t row = target.m_entities.size();
+        target.m_entities.push_back(id);
+        eraseRow(source, location.row);
+        m_locations.get_mut(id) = Location{targetIndex, row};
+    }
+
+    template <typename C>
+    static void moveComponent(Archetype& source, Archetype& target, size_t row,
+                              Signature shared) {
+        if (shared & signatureOf<C>()) {
+            target.template column<C>().push_back(
+                std::move(source.template column<C>()[row]));
+        }
+    }
+
+    void eraseRow(Archetype& archetype, size_t row) {
+        (eraseComponent<Components>(archetype, row), ...);
+        auto& entities = archetype.m_entities;
+        if (row + 1 != entities.size()) {
+            entities[row] = entities.back();
+            m_locations.get_mut(entities[row]).row = row;
+        }
+        entities.pop_back();
+    }
+
+    template <typename C>
+    static void eraseComponent(Archetype& archetype, size_t row) {
+        if (archetype.template has<C>()) {
+            auto& column = archetype.template column<C>();
+            if (row + 1 != column.size()) {
+                column[row] = std::move(column.back());
+            }
+            column.pop_back();
+        }
+    }
+
+    GenerationVector<Location> m_locations;
+    std::vector<Archetype> m_archetypes;
+    std::unordered_map<Signature, size_t> m_archetypeMap;
+};
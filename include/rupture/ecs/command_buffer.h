@@ -0,0 +1,371 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rupture/arena.h"
+#include "rupture/thread_pool.h"
+
+template <typename Storage>
+class CommandQueue;
+
+template <typename Storage>
+class CommandBuffer {
+   public:
+    using EntityId = typename Storage::EntityId;
+
+    class Pending {
+       public:
+        uint32_t index() const { return m_index; }
+
+       private:
+        friend CommandBuffer;
+
+        Pending(uint32_t index_, uint64_t epoch_)
+            : m_index{index_}, m_epoch{epoch_} {}
+
+        uint32_t m_index;
+        uint64_t m_epoch;
+    };
+
+    CommandBuffer() = default;
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&&) = default;
+
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(CommandBuffer&&) = default;
+
+    ~CommandBuffer() { clear(); }
+
+    template <typename... Cs>
+    Pending spawn(Cs... components) {
+        Pending pending{m_pendingCount++, m_epoch};
+        record(Command{SPAWN, EntityId::null(), pending.m_index, nullptr,
+                       nullptr, nullptr, nullptr});
+        (set(pending, std::move(components)), ...);
+        return pending;
+    }
+
+    void despawn(EntityId id) {
+        record(
+            Command{DESPAWN, id, NONE, nullptr, nullptr, nullptr, nullptr});
+    }
+
+    void despawn(Pending pending) {
+        check(pending, m_epoch);
+        record(Command{DESPAWN, EntityId::null(), pending.m_index, nullptr,
+                       nullptr, nullptr, nullptr});
+    }
+
+    template <typename C>
+    void set(EntityId id, C component) {
+        recordSet(id, NONE, std::move(component));
+    }
+
+    template <typename C>
+    void set(Pending pending, C component) {
+        check(pending, m_epoch);
+        recordSet(EntityId::null(), pending.m_index, std::move(component));
+    }
+
+    template <typename C>
+    void remove(EntityId id) {
+        record(Command{FIRST_COMPONENT + componentSlot<C>(), id, NONE, nullptr,
+                       &applyRemove<C>, nullptr, nullptr});
+    }
+
+    void apply(Storage& storage) {
+        CommandBuffer* self{this};
+        applyAll(storage, &self, 1);
+    }
+
+    EntityId spawned(Pending pending) const {
+        check(pending, m_spawnedEpoch);
+        return m_spawned.at(pending.m_index);
+    }
+
+    size_t size() const { return m_commands.size(); }
+    bool empty() const { return m_commands.empty(); }
+
+    void clear() {
+        for (auto& command : m_commands) {
+            if (command.destroy) {
+                command.destroy(command.payload);
+            }
+        }
+        m_commands.clear();
+        m_arena.reset();
+        m_pendingCount = 0;
+        m_epoch = nextEpoch();
+    }
+
+   private:
+    friend CommandQueue<Storage>;
+
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t SPAWN = 0;
+    static constexpr uint32_t DESPAWN = 1;
+    static constexpr uint32_t FIRST_COMPONENT = 2;
+
+    using Signature = typename Storage::Signature;
+    using Apply = void (*)(Storage&, EntityId, void*);
+    using Destroy = void (*)(void*);
+
+    struct Command {
+        uint32_t slot;
+        EntityId id;
+        uint32_t pending;
+        void* payload;
+        Apply apply;
+        Apply initialize;
+        Destroy destroy;
+    };
+
+    struct Entry {
+        uint32_t buffer;
+        uint32_t pending;
+        EntityId id;
+        uint32_t slot;
+        uint32_t order;
+        Command* command;
+
+        bool operator<(const Entry& rhs) const {
+            auto owner = pending == NONE ? 0 : buffer;
+            auto rhsOwner = rhs.pending == NONE ? 0 : rhs.buffer;
+            return std::tie(pending, owner, id, slot, buffer, order) <
+                   std::tie(rhs.pending, rhsOwner, rhs.id, rhs.slot,
+                            rhs.buffer, rhs.order);
+        }
+
+        bool sameEntity(const Entry& rhs) const {
+            return pending == rhs.pending && id == rhs.id &&
+                   (pending == NONE || buffer == rhs.buffer);
+        }
+    };
+
+    static uint64_t nextEpoch() {
+        static std::atomic<uint64_t> epoch{0};
+        return epoch.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    static void check(Pending pending, uint64_t epoch) {
+        if (pending.m_epoch != epoch) {
+            throw std::logic_error{
+                "Pending entity belongs to another or a cleared buffer"};
+        }
+    }
+
+    template <typename C>
+    static constexpr uint32_t componentSlot() {
+        return static_cast<uint32_t>(Storage::template componentIndex<C>());
+    }
+
+    template <typename C>
+    void recordSet(EntityId id, uint32_t pending, C component) {
+        auto payload = m_arena.create<C>(std::move(component));
+        record(Command{FIRST_COMPONENT + componentSlot<C>(), id, pending,
+                       payload, &applySet<C>, &applyInitialize<C>,
+                       &destroy<C>});
+    }
+
+    void record(Command command) { m_commands.push_back(command); }
+
+    template <typename C>
+    static void applySet(Storage& storage, EntityId id, void* payload) {
+        storage.set(id, std::move(*static_cast<C*>(payload)));
+    }
+
+    template <typename C>
+    static void applyInitialize(Storage& storage, EntityId id, void* payload) {
+        storage.initialize(id, std::move(*static_cast<C*>(payload)));
+    }
+
+    template <typename C>
+    static void applyRemove(Storage& storage, EntityId id, void*) {
+        storage.template remove<C>(id);
+    }
+
+    template <typename C>
+    static void destroy(void* payload) {
+        static_cast<C*>(payload)->~C();
+    }
+
+    static void applyAll(Storage& storage, CommandBuffer** buffers,
+                         size_t count) {
+        try {
+            applyEntries(storage, buffers, count);
+        } catch (...) {
+            for (size_t b{0}; b < count; b++) {
+                buffers[b]->clear();
+            }
+            throw;
+        }
+        for (size_t b{0}; b < count; b++) {
+            buffers[b]->clear();
+        }
+    }
+
+    static void applyEntries(Storage& storage, CommandBuffer** buffers,
+                             size_t count) {
+        std::vector<Entry> entries{};
+        for (size_t b{0}; b < count; b++) {
+            auto& commands = buffers[b]->m_commands;
+            for (size_t i{0}; i < commands.size(); i++) {
+                auto& command = commands[i];
+                entries.push_back(Entry{static_cast<uint32_t>(b),
+                                        command.pending, command.id,
+                                        command.slot, static_cast<uint32_t>(i),
+                                        &command});
+            }
+            buffers[b]->m_spawned.assign(buffers[b]->m_pendingCount,
+                                         EntityId::null());
+            buffers[b]->m_spawnedEpoch = buffers[b]->m_epoch;
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (size_t first{0}; first < entries.size();) {
+            auto last = first + 1;
+            while (last < entries.size() &&
+                   entries[last].sameEntity(entries[first])) {
+                last++;
+            }
+            applyEntity(storage, buffers, entries.data() + first,
+                        entries.data() + last);
+            first = last;
+        }
+    }
+
+    static void applyEntity(Storage& storage, CommandBuffer** buffers,
+                            const Entry* begin, const Entry* end) {
+        auto despawned = std::any_of(begin, end, [](const Entry& entry) {
+            return entry.slot == DESPAWN;
+        });
+        if (begin->pending != NONE) {
+            auto spawned = std::any_of(begin, end, [](const Entry& entry) {
+                return entry.slot == SPAWN;
+            });
+            if (spawned && !despawned) {
+                spawnEntity(storage, buffers, begin, end);
+            }
+            return;
+        }
+        if (despawned) {
+            storage.despawn(begin->id);
+            return;
+        }
+        forEachLatest(begin, end, [&storage, begin](const Command& command) {
+            command.apply(storage, begin->id, command.payload);
+        });
+    }
+
+    static void spawnEntity(Storage& storage, CommandBuffer** buffers,
+                            const Entry* begin, const Entry* end) {
+        Signature signature{0};
+        forEachLatest(begin, end, [&signature](const Command& command) {
+            if (command.initialize) {
+                signature |= Signature{1} << (command.slot - FIRST_COMPONENT);
+            }
+        });
+        auto id = storage.spawnWith(signature);
+        buffers[begin->buffer]->m_spawned[begin->pending] = id;
+        forEachLatest(begin, end, [&storage, id](const Command& command) {
+            if (command.initialize) {
+                command.initialize(storage, id, command.payload);
+            }
+        });
+    }
+
+    template <typename Func>
+    static void forEachLatest(const Entry* begin, const Entry* end,
+                              Func&& func) {
+        for (auto entry = begin; entry != end; entry++) {
+            auto next = entry + 1;
+            if (entry->slot < FIRST_COMPONENT ||
+                (next != end && next->slot == entry->slot)) {
+                continue;
+            }
+            func(*entry->command);
+        }
+    }
+
+    std::vector<Command> m_commands;
+    std::vector<EntityId> m_spawned;
+    LinearArena m_arena{16 * 1024};
+    uint32_t m_pendingCount{0};
+    uint64_t m_epoch{nextEpoch()};
+    uint64_t m_spawnedEpoch{0};
+};
+
+template <typename Storage>
+class CommandQueue {
+   public:
+    using Buffer = CommandBuffer<Storage>;
+
+    explicit CommandQueue(ThreadPool& pool) : m_pool{pool} {
+        m_buffers.resize(pool.workerCount());
+    }
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue(CommandQueue&&) = delete;
+
+    CommandQueue& operator=(const CommandQueue&) = delete;
+    CommandQueue& operator=(CommandQueue&&) = delete;
+
+    Buffer& local() {
+        auto index = m_pool.threadIndex();
+        if (index < m_buffers.size()) {
+            return m_buffers[index];
+        }
+        std::lock_guard<std::mutex> lock{m_externalMutex};
+        auto [at, inserted] = m_externalThreads.emplace(
+            std::this_thread::get_id(), m_external.size());
+        if (inserted) {
+            m_external.push_back(std::make_unique<Buffer>());
+        }
+        return *m_external[at->second];
+    }
+
+    void apply(Storage& storage) {
+        std::vector<Buffer*> buffers{};
+        for (auto& buffer : m_buffers) {
+            buffers.push_back(&buffer);
+        }
+        std::lock_guard<std::mutex> lock{m_externalMutex};
+        for (auto& buffer : m_external) {
+            buffers.push_back(buffer.get());
+        }
+        Buffer::applyAll(storage, buffers.data(), buffers.size());
+    }
+
+    size_t size() const {
+        size_t count{0};
+        for (const auto& buffer : m_buffers) {
+            count += buffer.size();
+        }
+        std::lock_guard<std::mutex> lock{m_externalMutex};
+        for (const auto& buffer : m_external) {
+            count += buffer->size();
+        }
+        return count;
+    }
+
+   private:
+    ThreadPool& m_pool;
+    std::vector<Buffer> m_buffers;
+    std::vector<std::unique_ptr<Buffer>> m_external;
+    std::unordered_map<std::thread::id, size_t> m_externalThreads;
+    mutable std::mutex m_externalMutex;
+};
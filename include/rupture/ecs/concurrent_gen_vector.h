@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "rupture/ecs/gen_vector.h"
+
+const size_t DEFAULT_MAX_CHUNKS = 1024;
+
+template <typename T, size_t ChunkSize = DEFAULT_CHUNK_SIZE,
+          size_t MaxChunks = DEFAULT_MAX_CHUNKS>
+class ConcurrentGenerationVector {
+   public:
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Concurrent readers copy items while they may be replaced");
+    static_assert(ChunkSize && (ChunkSize & (ChunkSize - 1)) == 0,
+                  "Chunk size must be a power of two");
+    static_assert(ChunkSize * MaxChunks < std::numeric_limits<uint32_t>::max(),
+                  "Slot count must fit into 32-bit index");
+
+    class Index {
+       public:
+        static Index null() { return Index{NONE, 0}; }
+
+        uint32_t index() const { return INDEX; }
+        uint32_t generation() const { return GENERATION; }
+
+        bool operator==(const Index& rhs) const {
+            return INDEX == rhs.INDEX && GENERATION == rhs.GENERATION;
+        }
+        bool operator!=(const Index& rhs) const { return !(*this == rhs); }
+        bool operator<(const Index& rhs) const {
+            return INDEX < rhs.INDEX ||
+                   (INDEX == rhs.INDEX && GENERATION < rhs.GENERATION);
+        }
+
+       private:
+        friend ConcurrentGenerationVector;
+
+        Index(uint32_t index_, uint32_t generation_)
+            : INDEX{index_}, GENERATION{generation_} {};
+        uint32_t INDEX;
+        uint32_t GENERATION;
+    };
+
+    ConcurrentGenerationVector() {
+        for (auto& chunk : m_chunks) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentGenerationVector(const ConcurrentGenerationVector&) = delete;
+    ConcurrentGenerationVector(ConcurrentGenerationVector&&) = delete;
+
+    ConcurrentGenerationVector& operator=(const ConcurrentGenerationVector&) =
+        delete;
+    ConcurrentGenerationVector& operator=(ConcurrentGenerationVector&&) =
+        delete;
+
+    ~ConcurrentGenerationVector() {
+        for (auto& chunk : m_chunks) {
+            delete chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    Index insert(const T& item) {
+        auto slotIndex = popFree();
+        auto& entry = slot(slotIndex);
+        // Pairs with the acquire fence in try_get: a reader that sees any of
+        // the new item words also sees the generation bump of the removal.
+        std::atomic_thread_fence(std::memory_order_release);
+        storeItem(entry, item);
+
+        auto generation = entry.generation.load(std::memory_order_relaxed) + 1;
+        entry.generation.store(generation, std::memory_order_release);
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        return Index{slotIndex, generation};
+    }
+
+    void remove(const Index& index) {
+        if (!tryRemove(index)) {
+            throw std::logic_error{"Invalid index generation"};
+        }
+    }
+
+    bool tryRemove(const Index& index) {
+        if (!allocated(index.INDEX)) {
+            return false;
+        }
+        auto& entry = slot(index.INDEX);
+        auto expected = index.GENERATION;
+        if (!(expected & LIVE_BIT) ||
+            !entry.generation.compare_exchange_strong(
+                expected, index.GENERATION + 1, std::memory_order_acq_rel)) {
+            return false;
+        }
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        pushFree(index.INDEX);
+        return true;
+    }
+
+    bool contains(const Index& index) const {
+        return allocated(index.INDEX) &&
+               slot(index.INDEX).generation.load(std::memory_order_acquire) ==
+                   index.GENERATION;
+    }
+
+    bool try_get(const Index& index, T& item) const {
+        if (!contains(index)) {
+            return false;
+        }
+        const auto& entry = slot(index.INDEX);
+        loadItem(entry, item);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return entry.generation.load(std::memory_order_relaxed) ==
+               index.GENERATION;
+    }
+
+    std::optional<T> get(const Index& index) const {
+        T item{};
+        if (try_get(index, item)) {
+            return item;
+        }
+        return std::nullopt;
+    }
+
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+    size_t capacity() const {
+        return std::min<size_t>(m_slotCount.load(std::memory_order_relaxed),
+                                ChunkSize * MaxChunks);
+    }
+
+   private:
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+    static constexpr uint32_t LIVE_BIT = 1;
+    static constexpr size_t ITEM_WORDS =
+        (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    struct Slot {
+        std::atomic<uint32_t> generation{0};
+        std::atomic<uint32_t> next{NONE};
+        std::array<std::atomic<uint64_t>, ITEM_WORDS> item{};
+    };
+
+    static void storeItem(Slot& entry, const T& item) {
+        std::array<uint64_t, ITEM_WORDS> words{};
+        std::memcpy(words.data(), &item, sizeof(T));
+        for (size_t i{0}; i < ITEM_WORDS; i++) {
+            entry.item[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    static void loadItem(const Slot& entry, T& item) {
+        std::array<uint64_t, ITEM_WORDS> words{};
+        for (size_t i{0}; i < ITEM_WORDS; i++) {
+            words[i] = entry.item[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(&item, words.data(), sizeof(T));
+    }
+
+    struct Chunk {
+        Slot slots[ChunkSize];
+    };
+
+    static uint64_t pack(uint32_t index, uint32_t tag) {
+        return static_cast<uint64_t>(tag) << 32 | index;
+    }
+
+    bool allocated(uint32_t index) const {
+        return index < ChunkSize * MaxChunks &&
+               m_chunks[index / ChunkSize].load(std::memory_order_acquire);
+    }
+
+    Slot& slot(uint32_t index) {
+        return m_chunks[index / ChunkSize]
+            .load(std::memory_order_acquire)
+            ->slots[index % ChunkSize];
+    }
+
+    const Slot& slot(uint32_t index) const {
+        return m_chunks[index / ChunkSize]
+            .load(std::memory_order_acquire)
+            ->slots[index % ChunkSize];
+    }
+
+    uint32_t popFree() {
+        auto head = m_freeHead.load(std::memory_order_acquire);
+        while (static_cast<uint32_t>(head) != NONE) {
+            auto index = static_cast<uint32_t>(head);
+            auto tag = static_cast<uint32_t>(head >> 32);
+            auto next = slot(index).next.load(std::memory_order_relaxed);
+            if (m_freeHead.compare_exchange_weak(head, pack(next, tag + 1),
+                                                 std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+                return index;
+            }
+        }
+        return allocateSlot();
+    }
+
+    void pushFree(uint32_t index) {
+        auto& entry = slot(index);
+        auto head = m_freeHead.load(std::memory_order_relaxed);
+        do {
+            entry.next.store(static_cast<uint32_t>(head),
+                             std::memory_order_relaxed);
+        } while (!m_freeHead.compare_exchange_weak(
+            head, pack(index, static_cast<uint32_t>(head >> 32) + 1),
+            std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    uint32_t allocateSlot() {
+        auto index = m_slotCount.fetch_add(1, std::memory_order_relaxed);
+        if (index >= ChunkSize * MaxChunks) {
+            throw std::length_error("ConcurrentGenerationVector is full");
+        }
+        auto& chunk = m_chunks[index / ChunkSize];
+        if (!chunk.load(std::memory_order_acquire)) {
+            auto fresh = new Chunk{};
+            Chunk* expected{nullptr};
+            if (!chunk.compare_exchange_strong(expected, fresh,
+                                               std::memory_order_acq_rel)) {
+                delete fresh;
+            }
+        }
+        return static_cast<uint32_t>(index);
+    }
+
+    std::array<std::atomic<Chunk*>, MaxChunks> m_chunks;
+    std::atomic<uint64_t> m_freeHead{pack(NONE, 0)};
+    std::atomic<size_t> m_slotCount{0};
+    std::atomic<size_t> m_size{0};
+};
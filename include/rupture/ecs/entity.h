@@ -4,65 +4,55 @@
 #include <optional>
 #include <tuple>
 
-template <typename C, typename Tuple>
-struct tuple_type_index;
-
-template <typename C>
-struct tuple_type_index<C, std::tuple<>> {
-    static constexpr size_t index = 0;
-};
-
-template <typename C, typename... Members>
-struct tuple_type_index<C, std::tuple<C, Members...>> {
-    static constexpr size_t index = 0;
-};
-
-template <typename C, typename F, typename... Members>
-struct tuple_type_index<C, std::tuple<F, Members...>> {
-    static constexpr size_t index =
-        1 + tuple_type_index<C, std::tuple<Members...>>::index;
-};
+#include "rupture/ecs/archetype.h"
 
 template <typename T, typename... Members>
 class Entity {
    public:
+    using Storage = ArchetypeStorage<T, Members...>;
+    using Id = typename Storage::EntityId;
+
+    Entity(Storage& storage, Id id) : m_storage{&storage}, m_id{id} {}
+
+    Entity(const Entity&) = default;
+    Entity(Entity&&) = default;
+
+    Entity& operator=(const Entity&) = default;
+    Entity& operator=(Entity&&) = default;
+
     template <typename A>
     void set(const A& component) {
-        get<A>() = component;
+        m_storage->set(m_id, component);
+    }
+
+    template <typename A>
+    void remove() {
+        m_storage->template remove<A>(m_id);
     }
 
     template <typename A>
-    void remove(const A& component) {
-        get<A>() = std::nullopt;
+    bool has() const {
+        return m_storage->template has<A>(m_id);
     }
 
     template <typename A, typename... Args>
     std::optional<std::tuple<A&, Args&...>> match() {
-        if (!match_component<A, Args...>(get<A>(), get<Args>()...)) {
+        if (!(has<A>() && (has<Args>() && ...))) {
             return std::nullopt;
         }
-        return std::tuple<A&, Args&...>(get<A>().value(),
-                                        get<Args>().value()...);
+        return std::tuple<A&, Args&...>(
+            *m_storage->template get<A>(m_id),
+            *m_storage->template get<Args>(m_id)...);
     }
 
-   private:
-    template <typename C>
-    std::optional<C>& get() {
-        return std::get<tuple_type_index<C, std::tuple<T, Members...>>::index>(
-            data);
-    };
+    Id id() const { return m_id; }
 
-    template <typename A, typename... Args>
-    bool match_component(std::optional<A>& arg, std::optional<Args>&... args) {
-        if (arg.has_value()) {
-            return match_component<Args...>(args...);
-        }
-        return false;
-    }
-
-    template <typename A>
-    bool match_component(std::optional<A>& arg) {
-        return arg.has_value();
-    }
-    std::tuple<std::optional<T>, std::optional<Members>...> data;
+   private:
+    Storage* m_storage;
+    Id m_id;
 };
+
+template <typename... Components>
+Entity(ArchetypeStorage<Components...>&,
+       typename ArchetypeStorage<Components...>::EntityId)
+    -> Entity<Components...>;
@@ -1,88 +1,304 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
 #include <limits>
-#include <optional>
-#include <set>
+#include <memory>
+#include <new>
 #include <stdexcept>
-#include <variant>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 const size_t DEFAULT_CAPACITY = 128;
+const size_t DEFAULT_CHUNK_SIZE = 1024;
 
-template <typename T>
+template <typename U, size_t ChunkSize = DEFAULT_CHUNK_SIZE>
+class ChunkedStorage {
+   public:
+    static_assert(ChunkSize && (ChunkSize & (ChunkSize - 1)) == 0,
+                  "Chunk size must be a power of two");
+
+    ChunkedStorage() = default;
+
+    ChunkedStorage(const ChunkedStorage& other) {
+        reserve(other.m_size);
+        for (size_t i{0}; i < other.m_size; i++) {
+            emplace_back(other[i]);
+        }
+    }
+
+    ChunkedStorage(ChunkedStorage&& other) noexcept
+        : m_chunks{std::move(other.m_chunks)}, m_size{other.m_size} {
+        other.m_size = 0;
+    }
+
+    ChunkedStorage& operator=(const ChunkedStorage& other) {
+        if (this != &other) {
+            ChunkedStorage copy{other};
+            swap(copy);
+        }
+        return *this;
+    }
+
+    ChunkedStorage& operator=(ChunkedStorage&& other) noexcept {
+        if (this != &other) {
+            clear();
+            m_chunks = std::move(other.m_chunks);
+            m_size = other.m_size;
+            other.m_size = 0;
+        }
+        return *this;
+    }
+
+    ~ChunkedStorage() { clear(); }
+
+    template <typename... Args>
+    U& emplace_back(Args&&... args) {
+        if (m_size == capacity()) {
+            m_chunks.emplace_back(std::make_unique<Chunk>());
+        }
+        auto& storage = m_chunks[m_size / ChunkSize]->items[m_size % ChunkSize];
+        auto item = new (&storage) U(std::forward<Args>(args)...);
+        m_size++;
+        return *item;
+    }
+
+    void pop_back() { (*this)[--m_size].~U(); }
+
+    U& operator[](size_t index) {
+        return *std::launder(reinterpret_cast<U*>(
+            &m_chunks[index / ChunkSize]->items[index % ChunkSize]));
+    }
+
+    const U& operator[](size_t index) const {
+        return *std::launder(reinterpret_cast<const U*>(
+            &m_chunks[index / ChunkSize]->items[index % ChunkSize]));
+    }
+
+    U& back() { return (*this)[m_size - 1]; }
+    const U& back() const { return (*this)[m_size - 1]; }
+
+    void reserve(size_t capacity_) {
+        while (capacity() < capacity_) {
+            m_chunks.emplace_back(std::make_unique<Chunk>());
+        }
+    }
+
+    void clear() {
+        while (m_size) {
+            pop_back();
+        }
+    }
+
+    void swap(ChunkedStorage& other) noexcept {
+        std::swap(m_chunks, other.m_chunks);
+        std::swap(m_size, other.m_size);
+    }
+
+    U* chunk(size_t index) {
+        return std::launder(reinterpret_cast<U*>(m_chunks[index]->items));
+    }
+
+    const U* chunk(size_t index) const {
+        return std::launder(
+            reinterpret_cast<const U*>(m_chunks[index]->items));
+    }
+
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_chunks.size() * ChunkSize; }
+
+    static constexpr size_t chunkSize() { return ChunkSize; }
+
+   private:
+    struct Chunk {
+        std::aligned_storage_t<sizeof(U), alignof(U)> items[ChunkSize];
+    };
+
+    std::vector<std::unique_ptr<Chunk>> m_chunks;
+    size_t m_size{0};
+};
+
+template <typename T, size_t ChunkSize = DEFAULT_CHUNK_SIZE>
 class GenerationVector {
    public:
     class Index {
+       public:
+        static Index null() { return Index{NONE, NONE}; }
+
+        uint32_t index() const { return INDEX; }
+        uint32_t generation() const { return GENERATION; }
+
+        bool operator==(const Index& rhs) const {
+            return INDEX == rhs.INDEX && GENERATION == rhs.GENERATION;
+        }
+        bool operator!=(const Index& rhs) const { return !(*this == rhs); }
+        bool operator<(const Index& rhs) const {
+            return INDEX < rhs.INDEX ||
+                   (INDEX == rhs.INDEX && GENERATION < rhs.GENERATION);
+        }
+
        private:
         friend GenerationVector;
 
-        Index(size_t index_, size_t generation_)
+        Index(uint32_t index_, uint32_t generation_)
             : INDEX{index_}, GENERATION{generation_} {};
-        const size_t INDEX;
-        const size_t GENERATION;
+        uint32_t INDEX;
+        uint32_t GENERATION;
+    };
+
+    template <bool Const>
+    class Iterator {
+       public:
+        using Container =
+            std::conditional_t<Const, const GenerationVector, GenerationVector>;
+        using value_type = T;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+        reference operator*() const { return container->m_items[position]; }
+
+        Iterator& operator++() {
+            position++;
+            return *this;
+        }
+
+        bool operator==(const Iterator& rhs) const {
+            return position == rhs.position;
+        }
+        bool operator!=(const Iterator& rhs) const {
+            return position != rhs.position;
+        }
+
+        Index handle() const { return container->handle(position); }
+
+       private:
+        friend GenerationVector;
+
+        Iterator(Container* container_, size_t position_)
+            : container{container_}, position{position_} {}
+
+        Container* container;
+        size_t position;
     };
 
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
     GenerationVector(size_t capacity = DEFAULT_CAPACITY)
-        : generation{0}, next_free_entry{0} {
-        items.resize(capacity);
-        for (size_t i{0}; i < items.size(); i++) {
-            items[i] = i + 1;
-        };
-        items.back() = std::numeric_limits<size_t>::max();
+        : next_free_entry{NONE} {
+        m_slots.reserve(capacity);
+        m_items.reserve(capacity);
+        m_itemSlots.reserve(capacity);
     };
 
-    Index insert(const T& item) {
-        size_t free_entry = next_free_entry;
-        next_free_entry = std::get<size_t>(items[free_entry]);
-        if (next_free_entry == std::numeric_limits<size_t>::max()) {
-            size_t num_items = items.size();
-            items.reserve(num_items * 2);
-            for (size_t i{num_items}; i < items.size(); i++) {
-                items[i] = i + 1;
+    Index insert(const T& item) { return emplace(item); }
+    Index insert(T&& item) { return emplace(std::move(item)); }
+
+    template <typename... Args>
+    Index emplace(Args&&... args) {
+        uint32_t slotIndex = next_free_entry;
+        if (slotIndex == NONE) {
+            if (m_slots.size() == NONE) {
+                throw std::length_error("GenerationVector index overflow");
             }
-            items.back() = std::numeric_limits<size_t>::max();
-            next_free_entry = num_items;
+            slotIndex = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back(Slot{NONE, 0});
         }
-        items[free_entry] = Entry{item, generation};
-        num_items++;
-        return Index{free_entry, generation};
+        auto& slot = m_slots[slotIndex];
+        m_items.emplace_back(std::forward<Args>(args)...);
+        m_itemSlots.emplace_back(slotIndex);
+        next_free_entry = slot.dense;
+        slot.dense = static_cast<uint32_t>(m_items.size() - 1);
+        return Index{slotIndex, slot.generation};
     }
 
     void remove(const Index& index) {
-        items[index.INDEX] = next_free_entry;
+        auto& slot = validSlot(index);
+        auto dense = slot.dense;
+        auto last = m_items.size() - 1;
+        if (dense != last) {
+            m_items[dense] = std::move(m_items.back());
+            m_itemSlots[dense] = m_itemSlots.back();
+            m_slots[m_itemSlots[dense]].dense = dense;
+        }
+        m_items.pop_back();
+        m_itemSlots.pop_back();
+
+        slot.generation++;
+        slot.dense = next_free_entry;
         next_free_entry = index.INDEX;
-        num_items--, generation++;
     };
 
-    T const& get(Index index) {
-        Entry& entry{std::get<Entry>(items[index.INDEX])};
-        if (entry.generation != index.GENERATION) {
-            throw std::logic_error{"Invalid index generation"};
-        }
-        return entry.item;
+    bool contains(const Index& index) const {
+        return index.INDEX < m_slots.size() &&
+               m_slots[index.INDEX].generation == index.GENERATION;
     }
 
-    T& get_mut(Index index) {
-        Entry& entry{std::get<Entry>(items[index.INDEX])};
-        if (entry.generation != index.GENERATION) {
-            throw std::logic_error{"Invalid index generation"};
+    T const& get(Index index) const {
+        return m_items[validSlot(index).dense];
+    }
+
+    T& get_mut(Index index) { return m_items[validSlot(index).dense]; }
+
+    const T* try_get(Index index) const {
+        return contains(index) ? &m_items[m_slots[index.INDEX].dense]
+                               : nullptr;
+    }
+
+    T* try_get_mut(Index index) {
+        return contains(index) ? &m_items[m_slots[index.INDEX].dense]
+                               : nullptr;
+    }
+
+    Index handle(size_t denseIndex) const {
+        auto slotIndex = m_itemSlots[denseIndex];
+        return Index{slotIndex, m_slots[slotIndex].generation};
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) {
+        for (size_t c{0}; c * ChunkSize < m_items.size(); c++) {
+            auto items = m_items.chunk(c);
+            auto count = std::min(ChunkSize, m_items.size() - c * ChunkSize);
+            for (size_t i{0}; i < count; i++) {
+                func(items[i]);
+            }
         }
-        return entry.item;
     }
 
-    size_t size() { return num_items; }
-    size_t capacity() { return items.capacity(); }
+    iterator begin() { return iterator{this, 0}; }
+    iterator end() { return iterator{this, m_items.size()}; }
+    const_iterator begin() const { return const_iterator{this, 0}; }
+    const_iterator end() const { return const_iterator{this, m_items.size()}; }
+
+    size_t size() const { return m_items.size(); }
+    size_t capacity() const { return m_items.capacity(); }
 
    private:
-    struct Entry {
-        Entry(const T& item_, size_t generation_)
-            : item{item_}, generation{generation_} {};
-        T item;
-        size_t generation;
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    struct Slot {
+        uint32_t dense;
+        uint32_t generation;
     };
-    std::vector<std::variant<size_t, Entry>> items;
-    size_t next_free_entry;
-    size_t generation;
-    size_t num_items;
-};
\ No newline at end of file
+
+    const Slot& validSlot(const Index& index) const {
+        if (!contains(index)) {
+            throw std::logic_error{"Invalid index generation"};
+        }
+        return m_slots[index.INDEX];
+    }
+
+    Slot& validSlot(const Index& index) {
+        if (!contains(index)) {
+            throw std::logic_error{"Invalid index generation"};
+        }
+        return m_slots[index.INDEX];
+    }
+
+    ChunkedStorage<Slot, ChunkSize> m_slots;
+    ChunkedStorage<T, ChunkSize> m_items;
+    ChunkedStorage<uint32_t, ChunkSize> m_itemSlots;
+    uint32_t next_free_entry;
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rupture/ecs/archetype.h"
+#include "rupture/thread_pool.h"
+#include "rupture/type_list.h"
+
+template <typename Storage, typename = void>
+struct TracksChanges : std::false_type {};
+
+template <typename Storage>
+struct TracksChanges<
+    Storage, std::void_t<decltype(std::declval<Storage&>().advanceTick())>>
+    : std::true_type {};
+
+template <typename Storage, typename Reads, typename Writes>
+class SystemView;
+
+template <typename Storage, typename... Reads, typename... Writes>
+class SystemView<Storage, Read<Reads...>, Write<Writes...>> {
+   public:
+    using EntityId = typename Storage::EntityId;
+
+    SystemView(Storage& storage, uint32_t lastRun = 0, uint32_t tick = 0)
+        : m_storage{storage}, m_lastRun{lastRun}, m_tick{tick} {}
+
+    template <typename A, typename... Args>
+    auto query() {
+        checkAccess<A>();
+        (checkAccess<Args>(), ...);
+        return m_storage.template query<A, Args...>();
+    }
+
+    template <typename C>
+    C* get(EntityId id) {
+        checkAccess<C>();
+        return m_storage.template get<C>(id);
+    }
+
+    template <typename C>
+    void markChanged(EntityId id) {
+        static_assert(TracksChanges<Storage>::value,
+                      "Storage does not track component changes");
+        static_assert(ContainsType<C, Writes...>::value,
+                      "Changed component must be declared as written");
+        m_storage.template markChanged<C>(id, m_tick);
+    }
+
+    uint32_t lastRun() const { return m_lastRun; }
+    uint32_t tick() const { return m_tick; }
+
+   private:
+    template <typename C>
+    static constexpr void checkAccess() {
+        using Component = std::remove_const_t<C>;
+        static_assert(ContainsType<Component, Reads..., Writes...>::value,
+                      "Component access not declared by system");
+        static_assert(std::is_const_v<C> ||
+                          ContainsType<Component, Writes...>::value,
+                      "Read-only component must be accessed as const");
+    }
+
+    Storage& m_storage;
+    uint32_t m_lastRun;
+    uint32_t m_tick;
+};
+
+template <typename Storage>
+class Scheduler;
+
+template <typename Storage>
+class SystemBase {
+   public:
+    virtual ~SystemBase() = default;
+
+   private:
+    friend class Scheduler<Storage>;
+
+    virtual void runOuter(Storage& storage) = 0;
+};
+
+template <typename Storage, typename Reads, typename Writes = Write<>>
+class System;
+
+template <typename Storage, typename... Reads, typename... Writes>
+class System<Storage, Read<Reads...>, Write<Writes...>>
+    : public SystemBase<Storage> {
+   public:
+    static_assert(!(ContainsType<Reads, Writes...>::value || ...),
+                  "Component declared as both read and written");
+
+    using View = SystemView<Storage, Read<Reads...>, Write<Writes...>>;
+    using Signature = typename Storage::Signature;
+
+    static constexpr Signature ReadSignature =
+        Storage::template signatureOf<Reads...>();
+    static constexpr Signature WriteSignature =
+        Storage::template signatureOf<Writes...>();
+
+   protected:
+    virtual void run(View&& view) = 0;
+
+   private:
+    void runOuter(Storage& storage) override {
+        uint32_t tick{0};
+        if constexpr (TracksChanges<Storage>::value) {
+            tick = storage.advanceTick();
+        }
+        run(View{storage, m_lastRun, tick});
+        m_lastRun = tick;
+    }
+
+    uint32_t m_lastRun{0};
+};
+
+template <typename Storage>
+class Scheduler {
+   public:
+    explicit Scheduler(ThreadPool& pool) : m_pool{pool} {}
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler(Scheduler&&) = delete;
+
+    Scheduler& operator=(const Scheduler&) = delete;
+    Scheduler& operator=(Scheduler&&) = delete;
+
+    template <typename S, typename... Args>
+    S& addSystem(Args&&... args) {
+        static_assert(std::is_base_of_v<SystemBase<Storage>, S>,
+                      "System must derive from System<Storage, ...>");
+        auto system = std::make_unique<S>(std::forward<Args>(args)...);
+        auto& ref = *system;
+
+        Node node{std::move(system), S::ReadSignature, S::WriteSignature};
+        auto index = m_nodes.size();
+        for (size_t i{0}; i < index; i++) {
+            if (conflicts(m_nodes[i], node)) {
+                m_nodes[i].dependents.push_back(index);
+                node.dependencies++;
+            }
+        }
+        m_nodes.push_back(std::move(node));
+        m_remaining = std::make_unique<std::atomic<size_t>[]>(m_nodes.size());
+        return ref;
+    }
+
+    void run(Storage& storage) {
+        for (size_t i{0}; i < m_nodes.size(); i++) {
+            m_remaining[i].store(m_nodes[i].dependencies,
+                                 std::memory_order_relaxed);
+        }
+        TaskGroup group{};
+        for (size_t i{0}; i < m_nodes.size(); i++) {
+            if (m_nodes[i].dependencies == 0) {
+                schedule(group, storage, i);
+            }
+        }
+        m_pool.wait(group);
+    }
+
+    size_t systemCount() const { return m_nodes.size(); }
+
+   private:
+    using Signature = typename Storage::Signature;
+
+    struct Node {
+        std::unique_ptr<SystemBase<Storage>> system;
+        Signature reads;
+        Signature writes;
+        std::vector<size_t> dependents{};
+        size_t dependencies{0};
+    };
+
+    static bool conflicts(const Node& first, const Node& second) {
+        return (first.writes & (second.reads | second.writes)) ||
+               (second.writes & first.reads);
+    }
+
+    void schedule(TaskGroup& group, Storage& storage, size_t index) {
+        m_pool.submit(group, [this, &group, &storage, index]() {
+            m_nodes[index].system->runOuter(storage);
+            for (auto dependent : m_nodes[index].dependents) {
+                if (m_remaining[dependent].fetch_sub(
+                        1, std::memory_order_acq_rel) == 1) {
+                    schedule(group, storage, dependent);
+                }
+            }
+        });
+    }
+
+    ThreadPool& m_pool;
+    std::vector<Node> m_nodes;
+    std::unique_ptr<std::atomic<size_t>[]> m_remaining;
+};
@@ -0,0 +1,536 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rupture/ecs/archetype.h"
+#include "rupture/ecs/gen_vector.h"
+
+const size_t SPARSE_PAGE_SIZE = 4096;
+
+inline bool isNewerTick(uint32_t tick, uint32_t since) {
+    return static_cast<int32_t>(tick - since) > 0;
+}
+
+template <typename T, typename EntityId>
+class SparsePool;
+
+template <typename EntityId, typename... Owned>
+class SparseGroup;
+
+template <typename EntityId>
+class SparseGroupBase {
+   public:
+    virtual ~SparseGroupBase() = default;
+
+   private:
+    template <typename, typename>
+    friend class SparsePool;
+
+    virtual void onEmplace(EntityId id) = 0;
+    virtual void onRemove(EntityId id) = 0;
+};
+
+template <typename T, typename EntityId>
+class SparsePool {
+   public:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    SparsePool() = default;
+
+    SparsePool(const SparsePool&) = delete;
+    SparsePool(SparsePool&&) = delete;
+
+    SparsePool& operator=(const SparsePool&) = delete;
+    SparsePool& operator=(SparsePool&&) = delete;
+
+    template <typename... Args>
+    T& emplace(EntityId id, Args&&... args) {
+        auto dense = index(id);
+        if (dense != npos) {
+            m_components[dense] = T(std::forward<Args>(args)...);
+            return m_components[dense];
+        }
+        sparse(id.index()) = static_cast<uint32_t>(m_entities.size());
+        m_entities.push_back(id);
+        m_components.emplace_back(std::forward<Args>(args)...);
+        m_addedTicks.push_back(0);
+        m_changedTicks.push_back(0);
+        if (m_group) {
+            m_group->onEmplace(id);
+        }
+        return m_components[index(id)];
+    }
+
+    bool remove(EntityId id) {
+        if (index(id) == npos) {
+            return false;
+        }
+        if (m_group) {
+            m_group->onRemove(id);
+        }
+        auto dense = index(id);
+        if (dense + 1 != m_entities.size()) {
+            m_entities[dense] = m_entities.back();
+            m_components[dense] = std::move(m_components.back());
+            m_addedTicks[dense] = m_addedTicks.back();
+            m_changedTicks[dense] = m_changedTicks.back();
+            sparse(m_entities[dense].index()) = static_cast<uint32_t>(dense);
+        }
+        m_entities.pop_back();
+        m_components.pop_back();
+        m_addedTicks.pop_back();
+        m_changedTicks.pop_back();
+        sparse(id.index()) = NONE;
+        return true;
+    }
+
+    bool contains(EntityId id) const { return index(id) != npos; }
+
+    size_t index(EntityId id) const {
+        auto page = id.index() / SPARSE_PAGE_SIZE;
+        if (page >= m_sparse.size() || !m_sparse[page]) {
+            return npos;
+        }
+        auto dense = (*m_sparse[page])[id.index() % SPARSE_PAGE_SIZE];
+        if (dense >= m_entities.size() || m_entities[dense] != id) {
+            return npos;
+        }
+        return dense;
+    }
+
+    T& get(EntityId id) {
+        auto item = try_get(id);
+        if (!item) {
+            throw std::logic_error{"Entity not present in SparsePool"};
+        }
+        return *item;
+    }
+
+    const T& get(EntityId id) const {
+        auto item = try_get(id);
+        if (!item) {
+            throw std::logic_error{"Entity not present in SparsePool"};
+        }
+        return *item;
+    }
+
+    T* try_get(EntityId id) {
+        auto dense = index(id);
+        return dense == npos ? nullptr : &m_components[dense];
+    }
+
+    const T* try_get(EntityId id) const {
+        auto dense = index(id);
+        return dense == npos ? nullptr : &m_components[dense];
+    }
+
+    void markAdded(EntityId id, uint32_t tick) {
+        auto dense = index(id);
+        if (dense != npos) {
+            m_addedTicks[dense] = tick;
+            m_changedTicks[dense] = tick;
+        }
+    }
+
+    void markChanged(EntityId id, uint32_t tick) {
+        auto dense = index(id);
+        if (dense != npos) {
+            m_changedTicks[dense] = tick;
+        }
+    }
+
+    uint32_t addedTick(size_t dense) const { return m_addedTicks[dense]; }
+    uint32_t changedTick(size_t dense) const { return m_changedTicks[dense]; }
+
+    const std::vector<EntityId>& entities() const { return m_entities; }
+    T* data() { return m_components.data(); }
+    const T* data() const { return m_components.data(); }
+
+    size_t size() const { return m_entities.size(); }
+
+    SparseGroupBase<EntityId>* group() const { return m_group; }
+
+   private:
+    template <typename, typename...>
+    friend class SparseGroup;
+
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+    using Page = std::array<uint32_t, SPARSE_PAGE_SIZE>;
+
+    uint32_t& sparse(uint32_t entity) {
+        auto page = entity / SPARSE_PAGE_SIZE;
+        if (page >= m_sparse.size()) {
+            m_sparse.resize(page + 1);
+        }
+        if (!m_sparse[page]) {
+            m_sparse[page] = std::make_unique<Page>();
+            m_sparse[page]->fill(NONE);
+        }
+        return (*m_sparse[page])[entity % SPARSE_PAGE_SIZE];
+    }
+
+    void swapDense(size_t first, size_t second) {
+        if (first == second) {
+            return;
+        }
+        std::swap(m_entities[first], m_entities[second]);
+        std::swap(m_components[first], m_components[second]);
+        std::swap(m_addedTicks[first], m_addedTicks[second]);
+        std::swap(m_changedTicks[first], m_changedTicks[second]);
+        sparse(m_entities[first].index()) = static_cast<uint32_t>(first);
+        sparse(m_entities[second].index()) = static_cast<uint32_t>(second);
+    }
+
+    std::vector<std::unique_ptr<Page>> m_sparse;
+    std::vector<EntityId> m_entities;
+    std::vector<T> m_components;
+    std::vector<uint32_t> m_addedTicks;
+    std::vector<uint32_t> m_changedTicks;
+    SparseGroupBase<EntityId>* m_group{nullptr};
+};
+
+template <typename EntityId, typename... Owned>
+class SparseGroup : public SparseGroupBase<EntityId> {
+   public:
+    static_assert(sizeof...(Owned) >= 2, "Group must own at least two pools");
+
+    SparseGroup(SparsePool<Owned, EntityId>&... pools) : m_pools{&pools...} {
+        if (((pools.m_group != nullptr) || ...)) {
+            throw std::logic_error{"Component pool already owned by a group"};
+        }
+        ((pools.m_group = this), ...);
+
+        const auto& lead = *std::get<0>(m_pools);
+        for (size_t i{0}; i < lead.size(); i++) {
+            onEmplace(lead.entities()[i]);
+        }
+    }
+
+    SparseGroup(const SparseGroup&) = delete;
+    SparseGroup(SparseGroup&&) = delete;
+
+    SparseGroup& operator=(const SparseGroup&) = delete;
+    SparseGroup& operator=(SparseGroup&&) = delete;
+
+    ~SparseGroup() override {
+        std::apply([](auto*... pools) { ((pools->m_group = nullptr), ...); },
+                   m_pools);
+    }
+
+    template <typename Func>
+    void forEach(Func&& func) {
+        std::tuple<Owned*...> columns{
+            std::get<SparsePool<Owned, EntityId>*>(m_pools)->data()...};
+        for (size_t i{0}; i < m_size; i++) {
+            func(std::get<Owned*>(columns)[i]...);
+        }
+    }
+
+    bool contains(EntityId id) const {
+        return std::get<0>(m_pools)->index(id) < m_size;
+    }
+
+    EntityId entity(size_t index) const {
+        return std::get<0>(m_pools)->entities()[index];
+    }
+
+    size_t size() const { return m_size; }
+
+   private:
+    void onEmplace(EntityId id) override {
+        auto shared = std::apply(
+            [id](auto*... pools) { return (pools->contains(id) && ...); },
+            m_pools);
+        if (!shared || contains(id)) {
+            return;
+        }
+        std::apply(
+            [this, id](auto*... pools) {
+                (pools->swapDense(pools->index(id), m_size), ...);
+            },
+            m_pools);
+        m_size++;
+    }
+
+    void onRemove(EntityId id) override {
+        if (!contains(id)) {
+            return;
+        }
+        m_size--;
+        std::apply(
+            [this, id](auto*... pools) {
+                (pools->swapDense(pools->index(id), m_size), ...);
+            },
+            m_pools);
+    }
+
+    std::tuple<SparsePool<Owned, EntityId>*...> m_pools;
+    size_t m_size{0};
+};
+
+template <typename... Components>
+class SparseStorage {
+   public:
+    static_assert(sizeof...(Components) <= 64,
+                  "SparseStorage supports up to 64 component types");
+
+    using Signature = uint64_t;
+    using EntityId = typename GenerationVector<Signature>::Index;
+
+    template <typename C>
+    using Pool = SparsePool<std::remove_const_t<C>, EntityId>;
+
+    template <typename C>
+    static constexpr size_t componentIndex() {
+        using Component = std::remove_const_t<C>;
+        static_assert((std::is_same_v<Component, Components> || ...),
+                      "Component not registered in SparseStorage");
+        return tuple_type_index<Component, std::tuple<Components...>>::index;
+    }
+
+    template <typename... Cs>
+    static constexpr Signature signatureOf() {
+        return (Signature{0} | ... | (Signature{1} << componentIndex<Cs>()));
+    }
+
+    template <typename A, typename... Args>
+    class Query {
+       public:
+        static constexpr size_t COUNT = sizeof...(Args) + 1;
+
+        template <typename C>
+        Query& added(uint32_t since) {
+            m_addedSince[queryIndex<C>()] = since;
+            return *this;
+        }
+
+        template <typename C>
+        Query& changed(uint32_t since) {
+            m_changedSince[queryIndex<C>()] = since;
+            return *this;
+        }
+
+        template <typename Func>
+        void forEach(Func&& func) const {
+            constexpr auto sequence = std::index_sequence_for<A, Args...>{};
+            for (auto id : *m_lead) {
+                Dense dense{std::get<Pool<A>*>(m_pools)->index(id),
+                            std::get<Pool<Args>*>(m_pools)->index(id)...};
+                if (matches(dense, sequence)) {
+                    call(func, dense, sequence);
+                }
+            }
+        }
+
+        size_t size() const {
+            size_t count{0};
+            forEach([&count](auto&...) { count++; });
+            return count;
+        }
+
+       private:
+        friend SparseStorage;
+
+        using Dense = std::array<size_t, COUNT>;
+
+        template <typename C>
+        static constexpr size_t queryIndex() {
+            constexpr auto index = tuple_type_index<
+                std::remove_const_t<C>,
+                std::tuple<std::remove_const_t<A>,
+                           std::remove_const_t<Args>...>>::index;
+            static_assert(index < COUNT, "Filtered component not in query");
+            return index;
+        }
+
+        template <size_t... I>
+        bool matches(const Dense& dense, std::index_sequence<I...>) const {
+            return ((dense[I] != Pool<A>::npos &&
+                     passes(*std::get<I>(m_pools), dense[I], I)) &&
+                    ...);
+        }
+
+        template <typename P>
+        bool passes(const P& pool, size_t dense, size_t i) const {
+            return (!m_addedSince[i] ||
+                    isNewerTick(pool.addedTick(dense), m_addedSince[i])) &&
+                   (!m_changedSince[i] ||
+                    isNewerTick(pool.changedTick(dense), m_changedSince[i]));
+        }
+
+        template <typename Func, size_t... I>
+        void call(Func& func, const Dense& dense,
+                  std::index_sequence<I...>) const {
+            func(static_cast<std::tuple_element_t<I, std::tuple<A, Args...>>&>(
+                std::get<I>(m_pools)->data()[dense[I]])...);
+        }
+
+        Query(Pool<A>& a, Pool<Args>&... args)
+            : m_pools{&a, &args...}, m_lead{&a.entities()} {
+            ((m_lead = args.size() < m_lead->size() ? &args.entities()
+                                                    : m_lead),
+             ...);
+        }
+
+        std::tuple<Pool<A>*, Pool<Args>*...> m_pools;
+        const std::vector<EntityId>* m_lead;
+        std::array<uint32_t, COUNT> m_addedSince{};
+        std::array<uint32_t, COUNT> m_changedSince{};
+    };
+
+    SparseStorage() = default;
+
+    SparseStorage(const SparseStorage&) = delete;
+    SparseStorage(SparseStorage&&) = delete;
+
+    SparseStorage& operator=(const SparseStorage&) = delete;
+    SparseStorage& operator=(SparseStorage&&) = delete;
+
+    template <typename... Cs>
+    EntityId spawn(Cs... components) {
+        constexpr Signature signature = signatureOf<Cs...>();
+        static_assert(sizeof...(Cs) == bitCount(signature),
+                      "Duplicate component types in spawn");
+        auto id = m_signatures.insert(signature);
+        (pool<Cs>().emplace(id, std::move(components)), ...);
+        auto tick_ = advanceTick();
+        (pool<Cs>().markAdded(id, tick_), ...);
+        return id;
+    }
+
+    void despawn(EntityId id) {
+        auto signature = m_signatures.get(id);
+        (removeIf<Components>(id, signature), ...);
+        m_signatures.remove(id);
+    }
+
+    template <typename C>
+    void set(EntityId id, C component) {
+        auto& signature = m_signatures.get_mut(id);
+        auto added = !(signature & signatureOf<C>());
+        signature |= signatureOf<C>();
+        pool<C>().emplace(id, std::move(component));
+        if (added) {
+            pool<C>().markAdded(id, advanceTick());
+        } else {
+            pool<C>().markChanged(id, advanceTick());
+        }
+    }
+
+    template <typename C>
+    void markChanged(EntityId id) {
+        pool<C>().markChanged(id, advanceTick());
+    }
+
+    template <typename C>
+    void markChanged(EntityId id, uint32_t tick_) {
+        pool<C>().markChanged(id, tick_);
+    }
+
+    template <typename C>
+    void remove(EntityId id) {
+        auto& signature = m_signatures.get_mut(id);
+        if (signature & signatureOf<C>()) {
+            signature &= ~signatureOf<C>();
+            pool<C>().remove(id);
+        }
+    }
+
+    template <typename C>
+    bool has(EntityId id) const {
+        return m_signatures.get(id) & signatureOf<C>();
+    }
+
+    template <typename C>
+    C* get(EntityId id) {
+        return pool<C>().try_get(id);
+    }
+
+    template <typename C>
+    const C* get(EntityId id) const {
+        return pool<C>().try_get(id);
+    }
+
+    bool contains(EntityId id) const { return m_signatures.contains(id); }
+
+    template <typename A, typename... Args>
+    Query<A, Args...> query() {
+        return Query<A, Args...>{pool<A>(), pool<Args>()...};
+    }
+
+    template <typename... Owned>
+    SparseGroup<EntityId, Owned...>& group() {
+        using Group = SparseGroup<EntityId, Owned...>;
+        auto owner = pool<std::tuple_element_t<0, std::tuple<Owned...>>>()
+                         .group();
+        if (owner) {
+            if (auto existing = dynamic_cast<Group*>(owner)) {
+                return *existing;
+            }
+        }
+        auto group = std::make_unique<Group>(pool<Owned>()...);
+        auto& ref = *group;
+        m_groups.push_back(std::move(group));
+        return ref;
+    }
+
+    template <typename C>
+    Pool<C>& pool() {
+        return std::get<componentIndex<C>()>(m_pools);
+    }
+
+    template <typename C>
+    const Pool<C>& pool() const {
+        return std::get<componentIndex<C>()>(m_pools);
+    }
+
+    uint32_t tick() const { return m_tick.load(std::memory_order_relaxed); }
+    uint32_t advanceTick() {
+        return m_tick.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    size_t size() const { return m_signatures.size(); }
+
+   private:
+    template <typename>
+    friend class CommandBuffer;
+
+    static constexpr size_t bitCount(Signature signature) {
+        size_t count{0};
+        for (; signature; signature &= signature - 1) count++;
+        return count;
+    }
+
+    EntityId spawnWith(Signature signature) {
+        return m_signatures.insert(signature);
+    }
+
+    template <typename C>
+    void initialize(EntityId id, C component) {
+        pool<C>().emplace(id, std::move(component));
+        pool<C>().markAdded(id, advanceTick());
+    }
+
+    template <typename C>
+    void removeIf(EntityId id, Signature signature) {
+        if (signature & signatureOf<C>()) {
+            pool<C>().remove(id);
+        }
+    }
+
+    GenerationVector<Signature> m_signatures;
+    std::tuple<SparsePool<Components, EntityId>...> m_pools;
+    std::vector<std::unique_ptr<SparseGroupBase<EntityId>>> m_groups;
+    std::atomic<uint32_t> m_tick{1};
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rupture/ecs/gen_vector.h"
+#include "rupture/thread_pool.h"
+
+const size_t DEFAULT_TRANSFORM_GRAIN = 1024;
+
+struct Transform {
+    glm::vec3 translation{0.0f};
+    glm::quat rotation{0.0f, 0.0f, 0.0f, 1.0f};
+    glm::vec3 scale{1.0f};
+
+    glm::mat4 matrix() const;
+};
+
+class TransformHierarchy {
+   public:
+    using Node = GenerationVector<uint32_t>::Index;
+
+    TransformHierarchy() = default;
+
+    TransformHierarchy(const TransformHierarchy&) = default;
+    TransformHierarchy(TransformHierarchy&&) = default;
+
+    TransformHierarchy& operator=(const TransformHierarchy&) = default;
+    TransformHierarchy& operator=(TransformHierarchy&&) = default;
+
+    Node create(const Transform& local = {}, Node parent = Node::null());
+    void destroy(Node node);
+    void setParent(Node node, Node parent);
+
+    bool contains(Node node) const;
+    Node parent(Node node) const;
+
+    void setLocal(Node node, const Transform& local);
+    void setTranslation(Node node, const glm::vec3& translation);
+    void setRotation(Node node, const glm::quat& rotation);
+    void setScale(Node node, const glm::vec3& scale);
+
+    Transform local(Node node) const;
+    const glm::mat4& world(Node node) const;
+
+    void update();
+    void update(ThreadPool& pool, size_t grainSize = DEFAULT_TRANSFORM_GRAIN);
+
+    const std::vector<Node>& nodes() const { return m_nodes; }
+    const std::vector<glm::mat4>& worldMatrices() const { return m_world; }
+    size_t size() const { return m_positions.size(); }
+
+   private:
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+    };
+
+    uint32_t position(Node node) const;
+    void markDirty(uint32_t index);
+    void growAncestors(uint32_t index);
+    void sort();
+    void reorder(const std::vector<uint32_t>& order);
+    void updateNode(size_t index);
+    void split(uint32_t index, size_t grainSize, std::vector<uint32_t>& spine,
+               std::vector<Range>& ranges) const;
+
+    GenerationVector<uint32_t> m_positions;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_subtreeSizes;
+    std::vector<glm::vec3> m_translations;
+    std::vector<glm::quat> m_rotations;
+    std::vector<glm::vec3> m_scales;
+    std::vector<glm::mat4> m_world;
+    std::vector<uint8_t> m_dirty;
+    bool m_anyDirty{false};
+    bool m_unsorted{false};
+};
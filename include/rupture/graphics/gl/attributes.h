@@ -149,6 +149,41 @@ struct InstanceAttribs<glm::mat4> {
     }
 };
 
+template <>
+struct InstanceAttribs<SkinInstance> {
+    static void setup(GLuint vertexArray, GLuint bufferIndex,
+                      GLuint& nextIndex) {
+        glVertexArrayAttribBinding(vertexArray, nextIndex, bufferIndex);
+        glVertexArrayAttribFormat(
+            vertexArray, nextIndex, 4, GL_FLOAT, GL_FALSE,
+            offsetof(SkinInstance, model) + sizeof(glm::vec4) * 0);
+        glEnableVertexArrayAttrib(vertexArray, nextIndex++);
+
+        glVertexArrayAttribBinding(vertexArray, nextIndex, bufferIndex);
+        glVertexArrayAttribFormat(
+            vertexArray, nextIndex, 4, GL_FLOAT, GL_FALSE,
+            offsetof(SkinInstance, model) + sizeof(glm::vec4) * 1);
+        glEnableVertexArrayAttrib(vertexArray, nextIndex++);
+
+        glVertexArrayAttribBinding(vertexArray, nextIndex, bufferIndex);
+        glVertexArrayAttribFormat(
+            vertexArray, nextIndex, 4, GL_FLOAT, GL_FALSE,
+            offsetof(SkinInstance, model) + sizeof(glm::vec4) * 2);
+        glEnableVertexArrayAttrib(vertexArray, nextIndex++);
+
+        glVertexArrayAttribBinding(vertexArray, nextIndex, bufferIndex);
+        glVertexArrayAttribFormat(
+            vertexArray, nextIndex, 4, GL_FLOAT, GL_FALSE,
+            offsetof(SkinInstance, model) + sizeof(glm::vec4) * 3);
+        glEnableVertexArrayAttrib(vertexArray, nextIndex++);
+
+        glVertexArrayAttribBinding(vertexArray, nextIndex, bufferIndex);
+        glVertexArrayAttribIFormat(vertexArray, nextIndex, 1, GL_UNSIGNED_INT,
+                                   offsetof(SkinInstance, paletteOffset));
+        glEnableVertexArrayAttrib(vertexArray, nextIndex++);
+    }
+};
+
 template <>
 struct InstanceAttribs<DebugInstance> {
     static void setup(GLuint vertexArray, GLuint bufferIndex,
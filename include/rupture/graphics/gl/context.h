@@ -3,6 +3,7 @@
 #include <glad/glad.h>
 
 #include <filesystem>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #include "rupture/graphics/gl/context.inl"
 #include "rupture/graphics/gl/environment.h"
 #include "rupture/graphics/gl/framebuffer.h"
+#include "rupture/graphics/gl/gpu_timer.h"
 #include "rupture/graphics/gl/light.h"
 #include "rupture/graphics/gl/material_pack.h"
 #include "rupture/graphics/gl/model.h"
@@ -26,6 +28,8 @@
 #include "rupture/graphics/gltf/mesh.h"
 #include "rupture/graphics/gltf/texture.h"
 #include "rupture/graphics/window.h"
+#include "rupture/profiler.h"
+#include "rupture/thread_pool.h"
 #include "rupture/typemap.h"
 #include "rupture/utility.h"
 
@@ -147,6 +151,10 @@ class Context {
                                      const std::vector<glm::vec3>& positions,
                                      const std::vector<glm::vec3>& intensities);
 
+    Profiler& profiler() { return m_profiler; }
+    GpuTimer& gpuTimer() { return m_gpuTimer; }
+    ThreadPool& threadPool();
+
    private:
     friend class ::Application;
 
@@ -311,6 +319,9 @@ class Context {
     Texture m_brdfMap;
 
     Commands m_commands;
+    Profiler m_profiler;
+    GpuTimer m_gpuTimer{m_profiler};
+    std::unique_ptr<ThreadPool> m_threadPool;
     TestPipeline m_pipeline;
 };
 
@@ -1,15 +1,21 @@
 #pragma once
 
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "rupture/graphics/gl/light.h"
 #include "rupture/graphics/gl/material_pack.h"
 #include "rupture/graphics/gl/renderer/mesh.h"
 #include "rupture/typemap.h"
 
 namespace gl {
-using MeshRenderers = TypeMap<
-    MeshRenderer<RigidVertex, glm::mat4>, MeshRenderer<RigidVertex, glm::vec3>,
-    MeshRenderer<SkinVertex, glm::mat4>, MeshRenderer<glm::vec3, DebugInstance>,
-    MeshRenderer<DebugVertex, DebugInstance>>;
+using MeshRenderers = TypeMap<MeshRenderer<RigidVertex, glm::mat4>,
+                              MeshRenderer<RigidVertex, glm::vec3>,
+                              MeshRenderer<SkinVertex, SkinInstance>,
+                              MeshRenderer<glm::vec3, DebugInstance>,
+                              MeshRenderer<DebugVertex, DebugInstance>>;
 
 template <typename Vert>
 using CommandIndex =
@@ -24,7 +30,7 @@ using CommandBufferMap =
 
 using Commands = StaticTypeMap<CommandBufferMap<RigidVertex, glm::mat4>,
                                CommandBufferMap<RigidVertex, glm::vec3>,
-                               CommandBufferMap<SkinVertex, glm::mat4>,
+                               CommandBufferMap<SkinVertex, SkinInstance>,
                                CommandBufferMap<glm::vec3, DebugInstance>,
                                CommandBufferMap<DebugVertex, DebugInstance>>;
 
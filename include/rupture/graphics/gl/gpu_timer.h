@@ -0,0 +1,79 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rupture/profiler.h"
+
+namespace gl {
+
+class GpuTimer {
+   public:
+    static const size_t FRAME_LATENCY = 3;
+
+    class Scope {
+       public:
+        Scope(GpuTimer* timer, const char* name) : m_timer{timer} {
+            if (m_timer) {
+                m_timer->begin(name);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        ~Scope() {
+            if (m_timer) {
+                m_timer->end();
+            }
+        }
+
+       private:
+        GpuTimer* m_timer;
+    };
+
+    explicit GpuTimer(Profiler& profiler) : m_profiler{profiler} {}
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer(GpuTimer&&) = delete;
+
+    GpuTimer& operator=(const GpuTimer&) = delete;
+    GpuTimer& operator=(GpuTimer&&) = delete;
+
+    ~GpuTimer();
+
+    void beginFrame();
+    size_t dropped() const { return m_dropped; }
+
+   private:
+    struct Query {
+        GLuint query;
+        const char* name;
+        uint64_t frame;
+        int64_t begin;
+    };
+
+    struct Frame {
+        std::vector<Query> queries{};
+        size_t used{0};
+    };
+
+    void begin(const char* name);
+    void end();
+    void startQuery(const char* name);
+
+    Profiler& m_profiler;
+    std::array<Frame, FRAME_LATENCY> m_frames{};
+    size_t m_current{0};
+    size_t m_dropped{0};
+    std::vector<const char*> m_scopes;
+};
+
+}  // namespace gl
@@ -1,242 +1,509 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <tuple>
 #include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
 
-template <typename U, typename... Types>
-struct ContainsType {
-    static constexpr bool value = (std::is_same_v<U, Types> || ...);
-};
+#include "rupture/graphics/gl/gpu_timer.h"
+#include "rupture/profiler.h"
+#include "rupture/thread_pool.h"
+#include "rupture/type_list.h"
+
+template <typename... Stages>
+class Pipeline;
+
+template <typename Reads, typename Writes>
+class PipelineStageBase;
 
-template <typename... Types>
-class UniqueTypeList;
+template <typename... Reads, typename... Writes>
+class PipelineStageBase<Read<Reads...>, Write<Writes...>> {
+    static_assert(!(ContainsType<Reads, Writes...>::value || ...),
+                  "Resource cannot be both read and written by a stage");
 
-template <typename U, typename... Types>
-class UniqueTypeList<U, Types...> {
    public:
-    template <typename T>
-    constexpr const T& get() const {
-        return getInner<T>();
-    }
+    using ReadList = Read<Reads...>;
+    using WriteList = Write<Writes...>;
+    using ResourceList = UniqueTypeListType<Reads..., Writes...>;
+    using ResourceView = ListView<const Reads..., Writes...>;
 
-    template <typename T>
-    constexpr T& get() {
-        return getInner<T>();
-    }
+    static constexpr bool ContextThread = true;
+    static constexpr bool Fusable = false;
+
+    virtual ~PipelineStageBase() = default;
 
    private:
-    template <typename T>
-    constexpr T& getInner() {
-        if constexpr (std::is_same_v<U, T>) {
-            return head;
-        } else {
-            return tail.template get<T>();
-        }
+    template <typename... Stages>
+    friend class Pipeline;
+
+    template <typename Storage>
+    void executeOuter(Storage& resources) {
+        execute(ResourceView{resources});
     }
 
-    U head;
-    UniqueTypeList<Types...> tail;
+   protected:
+    virtual void execute(ResourceView&& resources) = 0;
+};
+
+template <typename... Resources>
+class PipelineStage : public PipelineStageBase<Read<>, Write<Resources...>> {
 };
 
-template <typename U>
-class UniqueTypeList<U> {
+template <typename... Reads, typename... Writes>
+class PipelineStage<Read<Reads...>, Write<Writes...>>
+    : public PipelineStageBase<Read<Reads...>, Write<Writes...>> {};
+
+template <typename Derived, typename Reads, typename Writes>
+class FusableStage : public PipelineStage<Reads, Writes> {
    public:
-    template <typename T>
-    constexpr const T& get() const {
-        return getInner<T>();
-    }
+    using ResourceView = typename PipelineStage<Reads, Writes>::ResourceView;
 
-    template <typename T>
-    constexpr T& get() {
-        return getInner<T>();
+    static constexpr bool Fusable = true;
+
+   protected:
+    void execute(ResourceView&& resources) override {
+        static_cast<Derived&>(*this).process(resources);
     }
+};
+
+template <typename Stage, typename View>
+class FusedStageView {
+   public:
+    explicit FusedStageView(View& view) : m_view{view} {}
 
-   private:
     template <typename T>
-    constexpr T& getInner() {
-        constexpr bool isSame = std::is_same_v<U, T>;
-        if constexpr (isSame) {
-            return head;
+    auto& get() const {
+        using Resource = std::remove_const_t<T>;
+        static_assert(
+            ListContainsType<Resource, typename Stage::ResourceList>::value,
+            "Resource not declared by stage");
+        if constexpr (ListContainsType<Resource,
+                                       typename Stage::WriteList>::value) {
+            return m_view.template get<Resource>();
         } else {
-            static_assert(isSame, "Type not found in UniqueTypeList");
+            return std::as_const(m_view.template get<Resource>());
         }
     }
 
-    U head;
+   private:
+    View& m_view;
 };
 
-template <typename... Views>
-class ListView;
+template <typename Stage, typename = void>
+struct StageName {
+    static const char* get() { return typeid(Stage).name(); }
+};
 
-template <typename V, typename... Views>
-class ListView<V, Views...> {
-   public:
-    template <typename List>
-    constexpr ListView(List& list)
-        : head(list.template get<V>()), tail(ListView<Views...>{list}) {}
+template <typename Stage>
+struct StageName<Stage, std::void_t<decltype(Stage::Name)>> {
+    static const char* get() { return Stage::Name; }
+};
 
-    template <typename T>
-    constexpr const T& get() const {
-        return getInner<T>();
+template <typename First, typename Second>
+struct OverlapsType;
+
+template <template <typename...> class First, typename... As,
+          template <typename...> class Second, typename... Bs>
+struct OverlapsType<First<As...>, Second<Bs...>> {
+    static constexpr bool value = (ContainsType<As, Bs...>::value || ...);
+};
+
+template <typename First, typename Second>
+constexpr bool stagesConflict() {
+    using FirstWrites = typename First::WriteList;
+    using SecondWrites = typename Second::WriteList;
+    return OverlapsType<FirstWrites, typename Second::ReadList>::value ||
+           OverlapsType<FirstWrites, SecondWrites>::value ||
+           OverlapsType<typename First::ReadList, SecondWrites>::value;
+}
+
+template <typename Stages, size_t Stage, size_t... Is>
+constexpr uint64_t stageDependencies(std::index_sequence<Is...>) {
+    return (uint64_t{0} | ... |
+            (Is < Stage && stagesConflict<std::tuple_element_t<Is, Stages>,
+                                          std::tuple_element_t<Stage, Stages>>()
+                 ? uint64_t{1} << Is
+                 : uint64_t{0}));
+}
+
+template <typename Stages, size_t... Is>
+constexpr auto pipelineDependencies(std::index_sequence<Is...> stages) {
+    return std::array<uint64_t, sizeof...(Is)>{
+        stageDependencies<Stages, Is>(stages)...};
+}
+
+template <size_t N>
+constexpr std::array<size_t, N> fuseStages(const std::array<bool, N>& fusable,
+                                           const std::array<bool, N>& context) {
+    std::array<size_t, N> groups{};
+    size_t group{0};
+    for (size_t i{0}; i < N; i++) {
+        if (i > 0 && !(fusable[i] && fusable[i - 1] &&
+                       context[i] == context[i - 1])) {
+            group++;
+        }
+        groups[i] = group;
     }
+    return groups;
+}
 
-    template <typename T>
-    constexpr T& get() {
-        return getInner<T>();
+template <size_t Groups, size_t N>
+constexpr std::array<size_t, Groups + 1> groupBounds(
+    const std::array<size_t, N>& groups) {
+    std::array<size_t, Groups + 1> bounds{};
+    for (size_t i{N}; i-- > 0;) {
+        bounds[groups[i]] = i;
     }
+    bounds[Groups] = N;
+    return bounds;
+}
 
-   private:
-    template <typename T>
-    constexpr T& getInner() {
-        if constexpr (std::is_same_v<T, V>) {
-            return head;
-        } else {
-            return tail.template get<T>();
+template <size_t Groups, size_t N>
+constexpr std::array<uint64_t, Groups> groupDependencies(
+    const std::array<size_t, N>& groups,
+    const std::array<uint64_t, N>& dependencies) {
+    std::array<uint64_t, Groups> result{};
+    for (size_t i{0}; i < N; i++) {
+        for (size_t j{0}; j < i; j++) {
+            if ((dependencies[i] & (uint64_t{1} << j)) != 0 &&
+                groups[j] != groups[i]) {
+                result[groups[i]] |= uint64_t{1} << groups[j];
+            }
         }
     }
+    return result;
+}
 
-    V& head;
-    ListView<Views...> tail;
+template <typename Stages, size_t Begin, typename Indices>
+struct StageRange;
+
+template <typename Stages, size_t Begin, size_t... Is>
+struct StageRange<Stages, Begin, std::index_sequence<Is...>> {
+    using type = TypeList<std::tuple_element_t<Begin + Is, Stages>...>;
 };
 
-template <typename V>
-class ListView<V> {
+template <typename Shared, typename... Scratches>
+class PipelineStorage {
    public:
-    template <typename List>
-    constexpr ListView(List& list) : head(list.template get<V>()) {}
-
-    template <typename T>
-    constexpr const T& get() const {
-        return getInner<T>();
-    }
+    PipelineStorage(Shared& shared, Scratches&... scratches)
+        : m_shared{shared}, m_scratches{scratches...} {}
 
     template <typename T>
-    constexpr T& get() {
-        return getInner<T>();
+    T& get() {
+        return find<T, 0>();
     }
 
    private:
-    template <typename T>
-    constexpr T& getInner() {
-        constexpr bool isSame = std::is_same_v<T, V>;
-        if constexpr (isSame) {
-            return head;
+    template <typename T, size_t Index>
+    T& find() {
+        if constexpr (Index == sizeof...(Scratches)) {
+            return m_shared.template get<T>();
+        } else if constexpr (ListContainsType<
+                                 T, std::tuple_element_t<
+                                        Index, std::tuple<Scratches...>>>::
+                                 value) {
+            return std::get<T>(std::get<Index>(m_scratches));
         } else {
-            static_assert(isSame, "Type not found in UniqueTypeList");
+            return find<T, Index + 1>();
         }
     }
 
-    V& head;
+    Shared& m_shared;
+    std::tuple<Scratches&...> m_scratches;
 };
 
-template <typename U, typename... T>
-constexpr auto make_uniqueTypeListBuilder();
+template <typename... Stages>
+class Pipeline {
+    static_assert(sizeof...(Stages) > 0, "Pipeline needs at least one stage");
+    static_assert(sizeof...(Stages) <= 64,
+                  "Pipeline supports at most 64 stages");
+
+    template <typename Stage>
+    using StageResources =
+        typename ConcatTypeLists<typename Stage::ReadList,
+                                 typename Stage::WriteList>::type;
+
+    template <typename T>
+    struct IsDead {
+        static constexpr size_t accesses =
+            (size_t{ListContainsType<T, StageResources<Stages>>::value} + ...);
+        static constexpr size_t writes =
+            (size_t{ListContainsType<T, typename Stages::WriteList>::value} +
+             ...);
+        static constexpr bool value = accesses == 1 && writes == 1;
+    };
+
+    template <typename T>
+    struct IsLive : std::bool_constant<!IsDead<T>::value> {};
+
+    template <typename Stage>
+    using StageScratch = typename RebindTypes<
+        std::tuple,
+        typename FilterTypes<IsDead, typename Stage::WriteList>::type>::type;
+
+    using AllResources = typename UniqueTypes<
+        typename ConcatTypeLists<StageResources<Stages>...>::type>::type;
 
-template <typename... Types>
-class UniqueTypeListBuilder {
    public:
-    using TypeList = UniqueTypeList<Types...>;
+    using Mask = uint64_t;
+    using StageList = UniqueTypeListType<Stages...>;
+    using LiveResources = typename FilterTypes<IsLive, AllResources>::type;
+    using DeadResources = typename FilterTypes<IsDead, AllResources>::type;
+    using ResourceStorage =
+        typename RebindTypes<UniqueTypeList, LiveResources>::type;
+
+    static constexpr size_t StageCount = sizeof...(Stages);
+    static constexpr std::array<Mask, StageCount> Dependencies =
+        pipelineDependencies<std::tuple<Stages...>>(
+            std::index_sequence_for<Stages...>{});
+    static constexpr std::array<bool, StageCount> ContextStages{
+        Stages::ContextThread...};
+    static constexpr std::array<bool, StageCount> FusableStages{
+        Stages::Fusable...};
+
+    static constexpr std::array<size_t, StageCount> GroupOf =
+        fuseStages(FusableStages, ContextStages);
+    static constexpr size_t GroupCount = GroupOf[StageCount - 1] + 1;
+    static constexpr std::array<size_t, GroupCount + 1> GroupBounds =
+        groupBounds<GroupCount>(GroupOf);
+    static constexpr std::array<Mask, GroupCount> GroupDependencies =
+        groupDependencies<GroupCount>(GroupOf, Dependencies);
+
+    template <size_t Group>
+    using GroupStages = typename StageRange<
+        std::tuple<Stages...>, GroupBounds[Group],
+        std::make_index_sequence<GroupBounds[Group + 1] -
+                                 GroupBounds[Group]>>::type;
 
-    constexpr TypeList build() const { return TypeList{}; }
+   private:
+    template <size_t... Gs>
+    static auto groupLayout(std::index_sequence<Gs...>)
+        -> TypeList<GroupStages<Gs>...>;
+
+   public:
+    using Layout =
+        decltype(groupLayout(std::make_index_sequence<GroupCount>{}));
+
+    void setProfiler(Profiler* profiler, gl::GpuTimer* gpuTimer = nullptr) {
+        m_profiler = profiler;
+        m_gpuTimer = gpuTimer;
+    }
+
+    void execute() {
+        for (size_t i{0}; i < GroupCount; i++) {
+            runGroup(i, std::make_index_sequence<GroupCount>{});
+        }
+    }
+
+    void execute(ThreadPool& pool) {
+        for (size_t i{0}; i < GroupCount; i++) {
+            m_remaining[i].store(dependencyCount(i), std::memory_order_relaxed);
+        }
+        m_error = nullptr;
+
+        TaskGroup group{};
+        for (size_t i{0}; i < GroupCount; i++) {
+            if (GroupDependencies[i] == 0) {
+                schedule(pool, group, i);
+            }
+        }
+        while (true) {
+            auto done = group.done();
+            size_t index{0};
+            if (popContextGroup(index)) {
+                run(pool, group, index);
+            } else if (done) {
+                break;
+            } else if (!pool.runOne()) {
+                std::this_thread::yield();
+            }
+        }
+        pool.wait(group);
+        if (m_error) {
+            std::rethrow_exception(m_error);
+        }
+    }
 
    private:
-    template <typename U, typename... T>
-    friend constexpr auto make_uniqueTypeListBuilder();
+    using Runner = void (*)(Pipeline&);
 
-    template <typename U>
-    constexpr auto pushType() const {
-        if constexpr (ContainsType<U, Types...>::value) {
-            return *this;
-        } else {
-            return UniqueTypeListBuilder<U, Types...>{};
+    static constexpr size_t dependencyCount(size_t index) {
+        size_t count{0};
+        for (auto mask = GroupDependencies[index]; mask != 0;
+             mask &= mask - 1) {
+            count++;
         }
+        return count;
     }
-};
 
-template <typename U, typename... Types>
-constexpr auto make_uniqueTypeListBuilder() {
-    if constexpr (sizeof...(Types) == 0) {
-        return UniqueTypeListBuilder<U>{};
-    } else {
-        UniqueTypeListBuilder typeList{make_uniqueTypeListBuilder<Types...>()};
-        return typeList.template pushType<U>();
+    template <typename T, typename... GroupedStages>
+    static constexpr bool writtenBy(TypeList<GroupedStages...>) {
+        return (ListContainsType<T, typename GroupedStages::WriteList>::value ||
+                ...);
     }
-}
 
-template <typename... Types>
-using UniqueTypeListType =
-    decltype(make_uniqueTypeListBuilder<Types...>().build());
+    template <typename Group, typename... Types>
+    static auto fusedView(TypeList<Types...>) -> ListView<std::conditional_t<
+        writtenBy<Types>(Group{}), Types, const Types>...>;
 
-template <typename... Types1, typename... Types2>
-constexpr auto operator+(UniqueTypeList<Types1...>, UniqueTypeList<Types2...>) {
-    return make_uniqueTypeListBuilder<Types1..., Types2...>().build();
-}
+    template <size_t Stage>
+    auto& scratch() {
+        return std::get<Stage>(m_scratch);
+    }
 
-template <typename... Stages>
-class Pipeline;
+    template <size_t Group>
+    static void runFused(Pipeline& pipeline) {
+        constexpr auto begin = GroupBounds[Group];
+        constexpr auto size = GroupBounds[Group + 1] - begin;
+        if constexpr (size == 1) {
+            pipeline.runStage<begin>();
+        } else {
+            pipeline.runStages<begin>(std::make_index_sequence<size>{});
+        }
+    }
 
-template <typename... Resources>
-class PipelineStage {
-   public:
-    using ResourceList = UniqueTypeListType<Resources...>;
-    using ResourceView = ListView<Resources...>;
+    template <size_t Index>
+    void runStage() {
+        using Stage = std::tuple_element_t<Index, std::tuple<Stages...>>;
+        auto name = StageName<Stage>::get();
+        Profiler::Scope cpuScope{m_profiler, name};
+        auto gpuTimer = Stage::ContextThread ? m_gpuTimer : nullptr;
+        gl::GpuTimer::Scope gpuScope{gpuTimer, name};
+        PipelineStorage storage{m_resources, scratch<Index>()};
+        m_stages.template get<Stage>().executeOuter(storage);
+    }
 
-   private:
-    template <typename... Stages>
-    friend class Pipeline;
+    template <size_t Begin, size_t... Is>
+    void runStages(std::index_sequence<Is...>) {
+        using Group = TypeList<
+            std::tuple_element_t<Begin + Is, std::tuple<Stages...>>...>;
+        using GroupResources = typename UniqueTypes<typename ConcatTypeLists<
+            StageResources<std::tuple_element_t<Begin + Is,
+                                                std::tuple<Stages...>>>...>::
+                                                        type>::type;
+        using View = decltype(fusedView<Group>(GroupResources{}));
+
+        PipelineStorage storage{m_resources, scratch<Begin + Is>()...};
+        View view{storage};
+        (processStage<std::tuple_element_t<Begin + Is, std::tuple<Stages...>>>(
+             view),
+         ...);
+    }
 
-    template <typename... Types>
-    void executeOuter(UniqueTypeList<Types...>& resources) {
-        execute(ResourceView{resources});
+    template <typename Stage, typename View>
+    void processStage(View& view) {
+        auto name = StageName<Stage>::get();
+        Profiler::Scope cpuScope{m_profiler, name};
+        auto gpuTimer = Stage::ContextThread ? m_gpuTimer : nullptr;
+        gl::GpuTimer::Scope gpuScope{gpuTimer, name};
+        FusedStageView<Stage, View> resources{view};
+        m_stages.template get<Stage>().process(resources);
     }
 
-   protected:
-    virtual void execute(ResourceView&& resources) = 0;
-};
+    template <size_t... Gs>
+    void runGroup(size_t group, std::index_sequence<Gs...>) {
+        static constexpr std::array<Runner, GroupCount> runners{
+            &runFused<Gs>...};
+        runners[group](*this);
+    }
 
-template <typename... Stages>
-class Pipeline {
-   public:
-    using StageList = UniqueTypeListType<Stages...>;
-    using ResourceStorage = decltype((typename Stages::ResourceList{} + ...));
+    void schedule(ThreadPool& pool, TaskGroup& group, size_t index) {
+        if (ContextStages[GroupBounds[index]]) {
+            std::lock_guard<std::mutex> lock{m_contextMutex};
+            m_contextGroups.push_back(index);
+        } else {
+            pool.submit(group,
+                        [this, &pool, &group, index]() {
+                            run(pool, group, index);
+                        });
+        }
+    }
 
-    void execute() {
-        (..., m_stages.template get<Stages>().executeOuter(m_resources));
+    bool popContextGroup(size_t& index) {
+        std::lock_guard<std::mutex> lock{m_contextMutex};
+        if (m_contextGroups.empty()) {
+            return false;
+        }
+        index = m_contextGroups.back();
+        m_contextGroups.pop_back();
+        return true;
+    }
+
+    void run(ThreadPool& pool, TaskGroup& group, size_t index) {
+        try {
+            runGroup(index, std::make_index_sequence<GroupCount>{});
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{m_contextMutex};
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+            return;
+        }
+        for (size_t i{index + 1}; i < GroupCount; i++) {
+            if ((GroupDependencies[i] & (Mask{1} << index)) != 0 &&
+                m_remaining[i].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                schedule(pool, group, i);
+            }
+        }
     }
 
-   private:
     StageList m_stages;
     ResourceStorage m_resources;
+    std::tuple<StageScratch<Stages>...> m_scratch;
+
+    std::array<std::atomic<size_t>, GroupCount> m_remaining{};
+    std::mutex m_contextMutex;
+    std::vector<size_t> m_contextGroups;
+    std::exception_ptr m_error;
+
+    Profiler* m_profiler{nullptr};
+    gl::GpuTimer* m_gpuTimer{nullptr};
 };
 
 class TestPipelineStage1 : public PipelineStage<int, double> {
+   public:
+    static constexpr bool ContextThread = false;
+
    protected:
     void execute(ResourceView&& resources) override {
-        std::cout << "Executing stage 1 with int and double" << std::endl;
         resources.get<int>() = 42;
         resources.get<double>() = 3.14;
     }
 };
 
 class TestPipelineStage2 : public PipelineStage<int, float> {
+   public:
+    static constexpr bool ContextThread = false;
+
    protected:
     void execute(ResourceView&& resources) override {
-        std::cout << "Executing stage 2 with int and float" << std::endl;
         resources.get<int>() += 1;
         resources.get<float>() = 2.71f;
     }
 };
 
 class TestPipelineStage3 : public PipelineStage<double, char> {
+   public:
+    static constexpr bool ContextThread = false;
+
    protected:
     void execute(ResourceView&& resources) override {
-        std::cout << "Executing stage 3 with double and char" << std::endl;
         resources.get<double>() *= 2.0;
         resources.get<char>() = 'A';
     }
 };
 
-class TestPipelineStage4 : public PipelineStage<int, double, float, char> {
+class TestPipelineStage4
+    : public PipelineStage<Read<int, double, float, char>, Write<>> {
    protected:
     void execute(ResourceView&& resources) override {
         std::cout << "Executing stage 4" << std::endl;
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "rupture/graphics/gl/framebuffer.h"
+#include "rupture/graphics/gl/pipeline.h"
+#include "rupture/graphics/gl/texture.h"
+
+namespace gl {
+
+struct TextureDesc {
+    GLenum format{GL_RGBA8};
+    size_t width{0};
+    size_t height{0};
+    size_t mipLevels{1};
+
+    bool operator==(const TextureDesc& rhs) const {
+        return format == rhs.format && width == rhs.width &&
+               height == rhs.height && mipLevels == rhs.mipLevels;
+    }
+    bool operator!=(const TextureDesc& rhs) const { return !(*this == rhs); }
+};
+
+class RenderGraph {
+    static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+   public:
+    enum class Kind {
+        Texture,
+        Buffer,
+    };
+
+    enum class Access {
+        Sampled,
+        Image,
+        Attachment,
+        Storage,
+    };
+
+    class Resource {
+       public:
+        uint32_t index() const { return m_index; }
+
+        bool operator==(const Resource& rhs) const {
+            return m_index == rhs.m_index;
+        }
+        bool operator!=(const Resource& rhs) const { return !(*this == rhs); }
+
+       private:
+        friend RenderGraph;
+
+        explicit Resource(uint32_t index_) : m_index{index_} {}
+
+        uint32_t m_index;
+    };
+
+    class Pass {
+       public:
+        uint32_t index() const { return m_index; }
+
+       private:
+        friend RenderGraph;
+
+        explicit Pass(uint32_t index_) : m_index{index_} {}
+
+        uint32_t m_index;
+    };
+
+    struct Lifetime {
+        uint32_t first;
+        uint32_t last;
+    };
+
+    class Builder {
+       public:
+        Builder& read(Resource resource, Access access = Access::Sampled);
+        Builder& write(Resource resource,
+                       Access access = Access::Attachment);
+        Builder& sideEffect();
+
+       private:
+        friend RenderGraph;
+
+        Builder(RenderGraph& graph, uint32_t pass)
+            : m_graph{graph}, m_pass{pass} {}
+
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+    };
+
+    class PassResources {
+       public:
+        GLuint object(Resource resource) const;
+        GLuint64 handle(Resource resource) const;
+        Framebuffer* framebuffer() const { return m_framebuffer; }
+
+       private:
+        friend RenderGraph;
+
+        PassResources(RenderGraph& graph, uint32_t pass,
+                      Framebuffer* framebuffer)
+            : m_graph{graph}, m_pass{pass}, m_framebuffer{framebuffer} {}
+
+        RenderGraph& m_graph;
+        uint32_t m_pass;
+        Framebuffer* m_framebuffer;
+    };
+
+    using Execute = std::function<void(PassResources&)>;
+
+    RenderGraph() = default;
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph(RenderGraph&&) = default;
+
+    RenderGraph& operator=(const RenderGraph&) = delete;
+    RenderGraph& operator=(RenderGraph&&) = default;
+
+    Resource createTexture(std::string name, const TextureDesc& desc);
+    Resource importTexture(std::string name, Texture& texture);
+    Resource importBuffer(std::string name, GLuint buffer);
+    void markOutput(Resource resource);
+
+    template <typename Setup>
+    Pass addPass(std::string name, Setup&& setup, Execute execute) {
+        auto index = static_cast<uint32_t>(m_passes.size());
+        m_passes.push_back(PassNode{std::move(name), std::move(execute)});
+        Builder builder{*this, index};
+        setup(builder);
+        m_compiled = false;
+        return Pass{index};
+    }
+
+    template <typename T>
+    void bind(Resource resource) {
+        auto access = kind(resource) == Kind::Buffer ? Access::Storage
+                                                     : Access::Sampled;
+        bind<T>(resource, access,
+                access == Access::Storage ? access : Access::Attachment);
+    }
+
+    template <typename T>
+    void bind(Resource resource, Access read, Access write) {
+        m_bindings[std::type_index{typeid(T)}] =
+            Binding{resource.m_index, read, write};
+    }
+
+    template <typename Stage>
+    Pass addStage(Execute execute) {
+        return addPass(
+            StageName<Stage>::get(),
+            [this](Builder& builder) {
+                useBindings(builder, typename Stage::ReadList{}, false);
+                useBindings(builder, typename Stage::WriteList{}, true);
+            },
+            std::move(execute));
+    }
+
+    void compile();
+    void execute();
+    void clear();
+
+    Kind kind(Resource resource) const {
+        return m_resources.at(resource.m_index).kind;
+    }
+    bool culled(Pass pass) const { return m_passes[pass.m_index].culled; }
+    GLbitfield barriers(Pass pass) const {
+        return m_passes[pass.m_index].barriers;
+    }
+    Lifetime lifetime(Resource resource) const {
+        return m_resources[resource.m_index].lifetime;
+    }
+    uint32_t physicalIndex(Resource resource) const {
+        return m_resources[resource.m_index].physical;
+    }
+    size_t physicalCount() const { return m_physicalDescs.size(); }
+
+   private:
+    struct Use {
+        uint32_t resource;
+        Access access;
+        bool write;
+    };
+
+    struct PassNode {
+        std::string name;
+        Execute execute;
+        std::vector<Use> uses{};
+        bool sideEffect{false};
+        bool culled{false};
+        GLbitfield barriers{0};
+    };
+
+    struct ResourceNode {
+        std::string name;
+        Kind kind;
+        TextureDesc desc;
+        GLuint object{GL_NONE};
+        GLuint64 handle{0};
+        bool imported{false};
+        bool output{false};
+        Lifetime lifetime{NONE, NONE};
+        uint32_t physical{NONE};
+    };
+
+    struct Binding {
+        uint32_t resource;
+        Access read;
+        Access write;
+    };
+
+    struct CachedFramebuffer {
+        std::vector<GLuint> attachments;
+        Framebuffer framebuffer;
+    };
+
+    static GLbitfield barrierBit(Access access);
+    static bool isIncoherent(Access access);
+    static Framebuffer::Attachment attachmentPoint(GLenum format,
+                                                   size_t& colorCount);
+
+    template <template <typename...> class List, typename... Types>
+    void useBindings(Builder& builder, List<Types...>, bool write) {
+        (useBinding(builder, std::type_index{typeid(Types)}, write), ...);
+    }
+
+    void useBinding(Builder& builder, std::type_index type, bool write);
+    void addUse(uint32_t pass, Resource resource, Access access, bool write);
+    void cull();
+    void computeLifetimes();
+    void alias();
+    void computeBarriers();
+    void allocate();
+    Framebuffer* framebuffer(const PassNode& pass);
+    const ResourceNode& resolve(uint32_t pass, Resource resource) const;
+
+    std::vector<PassNode> m_passes;
+    std::vector<ResourceNode> m_resources;
+    std::unordered_map<std::type_index, Binding> m_bindings;
+    std::vector<TextureDesc> m_physicalDescs;
+    std::vector<std::unique_ptr<Texture>> m_textures;
+    std::vector<TextureDesc> m_textureDescs;
+    std::vector<CachedFramebuffer> m_framebuffers;
+    bool m_compiled{false};
+};
+
+}  // namespace gl
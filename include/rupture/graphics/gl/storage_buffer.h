@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace gl {
+
+class StorageBuffer {
+   public:
+    static const GLuint64 FENCE_TIMEOUT = 1000000;
+
+    explicit StorageBuffer(size_t byteSize, size_t regions = 1)
+        : m_byteSize{byteSize}, m_fences(regions, nullptr) {
+        const GLbitfield flags =
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glCreateBuffers(1, &m_glBuffer);
+        glNamedBufferStorage(m_glBuffer, m_byteSize, nullptr, flags);
+        m_data = glMapNamedBufferRange(m_glBuffer, 0, m_byteSize, flags);
+        if (m_data == nullptr) {
+            glDeleteBuffers(1, &m_glBuffer);
+            throw std::runtime_error("Failed to map storage buffer");
+        }
+    }
+
+    StorageBuffer(const StorageBuffer&) = delete;
+    StorageBuffer(StorageBuffer&& other)
+        : m_glBuffer{other.m_glBuffer},
+          m_data{other.m_data},
+          m_byteSize{other.m_byteSize},
+          m_fences{std::move(other.m_fences)} {
+        other.m_glBuffer = GL_NONE;
+        other.m_data = nullptr;
+        other.m_fences.clear();
+    }
+
+    StorageBuffer& operator=(const StorageBuffer&) = delete;
+    StorageBuffer& operator=(StorageBuffer&& other) {
+        release();
+        m_glBuffer = other.m_glBuffer;
+        m_data = other.m_data;
+        m_byteSize = other.m_byteSize;
+        m_fences = std::move(other.m_fences);
+        other.m_glBuffer = GL_NONE;
+        other.m_data = nullptr;
+        other.m_fences.clear();
+        return *this;
+    }
+
+    ~StorageBuffer() { release(); }
+
+    template <typename Type>
+    Type* data() {
+        return static_cast<Type*>(m_data);
+    }
+
+    size_t byteSize() const { return m_byteSize; }
+
+    void fence(size_t region = 0) {
+        auto& fence = m_fences.at(region);
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+        fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+
+    void wait(size_t region = 0) {
+        auto& fence = m_fences.at(region);
+        if (fence == nullptr) {
+            return;
+        }
+        GLenum status{GL_TIMEOUT_EXPIRED};
+        while (status == GL_TIMEOUT_EXPIRED) {
+            status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+                                      FENCE_TIMEOUT);
+        }
+        glDeleteSync(fence);
+        fence = nullptr;
+        if (status == GL_WAIT_FAILED) {
+            throw std::runtime_error("Failed to wait for storage buffer");
+        }
+    }
+
+    void bind(GLuint binding) const {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_glBuffer);
+    }
+
+   private:
+    void release() {
+        for (auto& fence : m_fences) {
+            if (fence != nullptr) {
+                glDeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        if (m_glBuffer != GL_NONE) {
+            glUnmapNamedBuffer(m_glBuffer);
+            glDeleteBuffers(1, &m_glBuffer);
+            m_glBuffer = GL_NONE;
+        }
+        m_data = nullptr;
+    }
+
+    GLuint m_glBuffer{GL_NONE};
+    void* m_data{nullptr};
+    size_t m_byteSize;
+    std::vector<GLsync> m_fences;
+};
+
+}  // namespace gl
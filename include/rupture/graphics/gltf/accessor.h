@@ -0,0 +1,107 @@
+#pragma once
+
+#include <fx/gltf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+namespace gltf {
+
+class BufferTable {
+   public:
+    BufferTable() = default;
+    explicit BufferTable(const fx::gltf::Document& document) {
+        m_buffers.reserve(document.buffers.size());
+        for (const auto& buffer : document.buffers) {
+            m_buffers.push_back(Range{buffer.data.data(), buffer.data.size()});
+        }
+    }
+
+    BufferTable(const BufferTable&) = default;
+    BufferTable(BufferTable&&) = default;
+
+    BufferTable& operator=(const BufferTable&) = default;
+    BufferTable& operator=(BufferTable&&) = default;
+
+    void assign(size_t buffer, const uint8_t* data, size_t size) {
+        if (buffer >= m_buffers.size()) {
+            m_buffers.resize(buffer + 1, Range{nullptr, 0});
+        }
+        m_buffers[buffer] = Range{data, size};
+    }
+
+    const uint8_t* data(size_t buffer, size_t offset, size_t size) const {
+        const auto& range = m_buffers.at(buffer);
+        if (offset > range.size || size > range.size - offset) {
+            throw std::out_of_range("Buffer access out of range");
+        }
+        return range.data + offset;
+    }
+
+    size_t size() const { return m_buffers.size(); }
+
+   private:
+    struct Range {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    std::vector<Range> m_buffers;
+};
+
+template <typename T>
+class AccessorView {
+   public:
+    AccessorView(const uint8_t* data, size_t count, size_t stride)
+        : m_data{data}, m_count{count}, m_stride{stride} {}
+
+    T operator[](size_t index) const {
+        T item;
+        std::memcpy(&item, m_data + index * m_stride, sizeof(T));
+        return item;
+    }
+
+    void copy(T* output) const {
+        if (contiguous()) {
+            std::memcpy(output, m_data, m_count * sizeof(T));
+            return;
+        }
+        for (size_t i{0}; i < m_count; i++) {
+            std::memcpy(output + i, m_data + i * m_stride, sizeof(T));
+        }
+    }
+
+    const uint8_t* bytes() const { return m_data; }
+    size_t size() const { return m_count; }
+    size_t stride() const { return m_stride; }
+    bool contiguous() const { return m_stride == sizeof(T); }
+
+   private:
+    const uint8_t* m_data;
+    size_t m_count;
+    size_t m_stride;
+};
+
+template <typename T>
+AccessorView<T> accessorView(const fx::gltf::Document& document,
+                             const BufferTable& buffers,
+                             const fx::gltf::Accessor& accessor) {
+    const auto& bufferView = document.bufferViews.at(accessor.bufferView);
+    size_t stride = bufferView.byteStride ? bufferView.byteStride : sizeof(T);
+    if (stride < sizeof(T)) {
+        throw std::invalid_argument("Accessor stride smaller than element");
+    }
+    size_t byteSize =
+        accessor.count > 0 ? stride * (accessor.count - 1) + sizeof(T) : 0;
+    if (accessor.byteOffset + byteSize > bufferView.byteLength) {
+        throw std::out_of_range("Accessor exceeds its buffer view");
+    }
+    return {buffers.data(bufferView.buffer,
+                         bufferView.byteOffset + accessor.byteOffset, byteSize),
+            accessor.count, stride};
+}
+
+}  // namespace gltf
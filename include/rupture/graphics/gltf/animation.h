@@ -15,6 +15,8 @@
 #include <unordered_map>
 #include <vector>
 
+#include "rupture/graphics/gltf/accessor.h"
+
 using namespace std::string_literals;
 
 namespace gltf {
@@ -22,6 +24,11 @@ namespace gltf {
 class Animation {
    public:
     Animation(const fx::gltf::Document& document,
+              const fx::gltf::Animation& animation,
+              const std::unordered_map<uint32_t, uint32_t>& skinNodeOrdering)
+        : Animation{document, BufferTable{document}, animation,
+                    skinNodeOrdering} {}
+    Animation(const fx::gltf::Document& document, const BufferTable& buffers,
               const fx::gltf::Animation& animation,
               const std::unordered_map<uint32_t, uint32_t>& skinNodeOrdering);
 
@@ -36,6 +43,10 @@ class Animation {
     friend class Skin;
     friend class Document;
     friend class AnimParserHelper;
+    friend class AnimationSampler;
+    friend class CompressedAnimation;
+
+    Animation() = default;
 
     static std::string getGltfUID(const std::filesystem::path& path,
                                   const fx::gltf::Document& document,
@@ -70,6 +81,8 @@ class Animation {
         CubicSpline,
     };
 
+    static const uint32_t HERMITE_COEFFICIENTS = 4;
+
     struct BufferView {
         uint32_t timeOffset;
         uint32_t targetOffset;
@@ -78,9 +91,14 @@ class Animation {
     };
 
     BufferView loadSamplerData(const fx::gltf::Document& document,
+                               const BufferTable& buffers,
                                const fx::gltf::Animation::Sampler& sampler,
                                Property property);
 
+    template <typename Comp>
+    static std::vector<Comp> hermiteCoefficients(
+        const std::vector<float>& times, const std::vector<Comp>& keys);
+
     glm::mat4 targetTransform(uint32_t nodeIndex, float time) const {
         auto& node = m_targets[nodeIndex];
         auto t = node.t.has_value()
@@ -155,15 +173,31 @@ class Animation {
                             return glm::mix(prev, next, t);
                         }
                     }
+                    case Interpolation::CubicSpline: {
+                        float t =
+                            (time - timeBuffer[view.timeOffset + offset - 1]) /
+                            (timeBuffer[view.timeOffset + offset] -
+                             timeBuffer[view.timeOffset + offset - 1]);
+                        const auto* c =
+                            &targetBuffer[view.targetOffset +
+                                          (offset - 1) * HERMITE_COEFFICIENTS];
+                        auto value = ((c[3] * t + c[2]) * t + c[1]) * t + c[0];
+                        if constexpr (std::is_same<glm::quat, Comp>::value) {
+                            return glm::normalize(value);
+                        } else {
+                            return value;
+                        }
+                    }
                     default:
                         throw std::runtime_error(
                             "Interpolation method not implemented");
                 }
-            } else if (offset == 0) {
-                return targetBuffer[view.targetOffset];
-            } else {
-                return targetBuffer[view.targetOffset + offset - 1];
             }
+            auto key = offset == 0 ? 0 : offset - 1;
+            if (view.mode == Interpolation::CubicSpline) {
+                key *= HERMITE_COEFFICIENTS;
+            }
+            return targetBuffer[view.targetOffset + key];
         }
     };
 
@@ -174,7 +208,7 @@ class Animation {
     AnimationBuffer<glm::quat> m_rotationBuffer;
 
     std::vector<Target> m_targets;
-    double m_duration;
+    double m_duration{0.0};
 };
 
 }  // namespace gltf
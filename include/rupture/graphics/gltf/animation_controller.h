@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "rupture/arena.h"
+#include "rupture/graphics/gltf/animation_sampler.h"
+#include "rupture/graphics/gltf/skin.h"
+
+namespace gltf {
+
+class AnimationController {
+   public:
+    enum class BlendMode { Override, Additive };
+
+    explicit AnimationController(const Skin& skin);
+
+    AnimationController(const AnimationController&) = default;
+    AnimationController(AnimationController&&) = default;
+
+    AnimationController& operator=(const AnimationController&) = default;
+    AnimationController& operator=(AnimationController&&) = default;
+
+    size_t addLayer(BlendMode mode, std::vector<float> mask = {},
+                    float weight = 1.0f);
+    size_t layerCount() const { return m_layers.size(); }
+
+    void play(size_t animation, float fadeDuration = 0.0f, bool loop = true,
+              size_t layer = 0);
+    void play(const std::string& name, float fadeDuration = 0.0f,
+              bool loop = true, size_t layer = 0) {
+        play(m_skin->animationIndex(name), fadeDuration, loop, layer);
+    }
+    void stop(size_t layer);
+
+    void setSpeed(size_t layer, float speed);
+    void setLayerWeight(size_t layer, float weight);
+    float layerWeight(size_t layer) const { return m_layers.at(layer).weight; }
+
+    void update(float deltaTime);
+    void evaluate(LinearArena& arena, const glm::mat4& rootTransform,
+                  Skin::Workspace& workspace, glm::mat4* output);
+
+    static void blend(const PoseView& target, const PoseView& source,
+                      float weight, const std::vector<float>& mask);
+
+   private:
+    struct Playback {
+        size_t animation;
+        float time;
+        float speed;
+        bool loop;
+        AnimationSampler::Cursor cursor;
+        PoseBuffer reference;
+    };
+
+    struct Layer {
+        BlendMode mode;
+        std::vector<float> mask;
+        float weight;
+        std::optional<Playback> current;
+        std::optional<Playback> previous;
+        std::optional<PoseBuffer> snapshot;
+        float fade;
+        float fadeDuration;
+    };
+
+    void advance(Playback& playback, float deltaTime) const;
+    void sampleFadeSource(Layer& layer, const PoseView& current,
+                          const PoseView& pose) const;
+    void sample(Playback& playback, BlendMode mode,
+                const PoseView& pose) const;
+
+    static void add(const PoseView& target, const PoseView& delta,
+                    float weight, const std::vector<float>& mask);
+
+    const Skin* m_skin;
+    std::vector<Layer> m_layers;
+};
+
+}  // namespace gltf
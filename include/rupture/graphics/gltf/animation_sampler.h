@@ -0,0 +1,195 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "rupture/arena.h"
+#include "rupture/graphics/gltf/animation.h"
+#include "rupture/graphics/gltf/compressed_animation.h"
+
+namespace gltf {
+
+class PoseView;
+
+class PoseBuffer {
+   public:
+    enum Component : size_t {
+        TranslationX,
+        TranslationY,
+        TranslationZ,
+        RotationX,
+        RotationY,
+        RotationZ,
+        RotationW,
+        ScaleX,
+        ScaleY,
+        ScaleZ,
+        ComponentCount,
+    };
+
+    PoseBuffer(size_t jointCount = 0, size_t instanceCount = 1);
+
+    PoseBuffer(const PoseBuffer&) = default;
+    PoseBuffer(PoseBuffer&&) = default;
+
+    PoseBuffer& operator=(const PoseBuffer&) = default;
+    PoseBuffer& operator=(PoseBuffer&&) = default;
+
+    void resize(size_t jointCount, size_t instanceCount);
+
+    float* component(size_t instance, size_t component) {
+        return m_data.data() + offset(instance, component);
+    }
+    const float* component(size_t instance, size_t component) const {
+        return m_data.data() + offset(instance, component);
+    }
+
+    glm::vec3 translation(size_t instance, size_t joint) const;
+    glm::quat rotation(size_t instance, size_t joint) const;
+    glm::vec3 scale(size_t instance, size_t joint) const;
+
+    void setTranslation(size_t instance, size_t joint, const glm::vec3& value);
+    void setRotation(size_t instance, size_t joint, const glm::quat& value);
+    void setScale(size_t instance, size_t joint, const glm::vec3& value);
+
+    PoseView view(size_t instance);
+
+    size_t jointCount() const { return m_jointCount; }
+    size_t instanceCount() const { return m_instanceCount; }
+    size_t stride() const { return m_stride; }
+
+   private:
+    size_t offset(size_t instance, size_t component) const {
+        return (instance * ComponentCount + component) * m_stride;
+    }
+
+    std::vector<float> m_data;
+    size_t m_jointCount{0};
+    size_t m_instanceCount{0};
+    size_t m_stride{0};
+};
+
+class PoseView {
+   public:
+    PoseView(float* data, size_t jointCount, size_t stride)
+        : m_data{data}, m_jointCount{jointCount}, m_stride{stride} {}
+
+    static PoseView allocate(LinearArena& arena, size_t jointCount);
+
+    float* component(size_t component) const {
+        return m_data + component * m_stride;
+    }
+
+    glm::vec3 translation(size_t joint) const;
+    glm::quat rotation(size_t joint) const;
+    glm::vec3 scale(size_t joint) const;
+
+    void copy(const PoseView& other) const;
+
+    size_t jointCount() const { return m_jointCount; }
+    size_t stride() const { return m_stride; }
+
+   private:
+    float* m_data;
+    size_t m_jointCount;
+    size_t m_stride;
+};
+
+inline PoseView PoseBuffer::view(size_t instance) {
+    return PoseView{component(instance, 0), m_jointCount, m_stride};
+}
+
+class AnimationSampler {
+   public:
+    class Cursor {
+       public:
+        Cursor() = default;
+
+       private:
+        friend AnimationSampler;
+
+        std::vector<uint32_t> m_keys;
+    };
+
+    explicit AnimationSampler(const Animation& animation);
+    explicit AnimationSampler(
+        std::shared_ptr<const CompressedAnimation> animation);
+
+    AnimationSampler(const AnimationSampler&) = default;
+    AnimationSampler(AnimationSampler&&) = default;
+
+    AnimationSampler& operator=(const AnimationSampler&) = default;
+    AnimationSampler& operator=(AnimationSampler&&) = default;
+
+    void sample(float time, Cursor& cursor, PoseBuffer& pose,
+                size_t instance = 0) const;
+    void sample(float time, Cursor& cursor, const PoseView& pose) const;
+    void sample(const float* times, Cursor* cursors, size_t count,
+                PoseBuffer& pose, size_t firstInstance = 0) const;
+
+    AnimationSampler withFrozenJoints(const std::vector<bool>& frozen) const;
+
+    size_t jointCount() const { return m_jointCount; }
+    double duration() const { return m_duration; }
+    bool compressed() const { return m_compressed != nullptr; }
+
+   private:
+    using Interpolation = Animation::Interpolation;
+
+    struct Channel {
+        uint32_t joint;
+        uint32_t timeOffset;
+        uint32_t keyOffset;
+        uint32_t samples;
+        Interpolation mode;
+    };
+
+    struct Segment {
+        uint32_t prev;
+        uint32_t next;
+        float alpha;
+    };
+
+    static Segment findSegment(const float* times, uint32_t samples,
+                               Interpolation mode, float time,
+                               uint32_t& cursor);
+
+    void sampleVectors(const std::vector<Channel>& channels,
+                       const Animation::AnimationBuffer<glm::vec3>& buffer,
+                       float time, uint32_t* cursors, float* x, float* y,
+                       float* z) const;
+    void sampleRotations(float time, uint32_t* cursors, float* x, float* y,
+                         float* z, float* w) const;
+    template <typename Comp>
+    void sampleCubic(const std::vector<Channel>& channels,
+                     const Animation::AnimationBuffer<Comp>& buffer,
+                     float time, uint32_t* cursors,
+                     float* const* outputs) const;
+    void sampleCompressedVectors(CompressedAnimation::Group group, float time,
+                                 uint32_t* cursors, float* x, float* y,
+                                 float* z) const;
+    void sampleCompressedRotations(float time, uint32_t* cursors, float* x,
+                                   float* y, float* z, float* w) const;
+
+    const Animation* m_animation;
+    std::shared_ptr<const CompressedAnimation> m_compressed;
+    size_t m_jointCount;
+    double m_duration;
+    std::vector<Channel> m_translations;
+    std::vector<Channel> m_rotations;
+    std::vector<Channel> m_scales;
+    std::vector<Channel> m_cubicTranslations;
+    std::vector<Channel> m_cubicRotations;
+    std::vector<Channel> m_cubicScales;
+    std::vector<uint32_t> m_staticTranslations;
+    std::vector<uint32_t> m_staticRotations;
+    std::vector<uint32_t> m_staticScales;
+    std::vector<uint32_t> m_tracks[CompressedAnimation::GroupCount];
+};
+
+}  // namespace gltf
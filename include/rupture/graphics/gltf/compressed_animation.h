@@ -0,0 +1,146 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "rupture/graphics/gltf/animation.h"
+
+namespace gltf {
+
+const size_t CACHE_LINE_SIZE = 64;
+
+struct CompressionSettings {
+    float translationError{1e-3f};
+    float rotationError{2e-4f};
+    float scaleError{1e-3f};
+    uint32_t cubicSubdivisions{8};
+};
+
+class CompressedAnimation {
+   public:
+    enum Group : size_t {
+        Translations,
+        Rotations,
+        Scales,
+        GroupCount,
+    };
+
+    static const uint32_t KEY_WORDS = 3;
+
+    struct Track {
+        uint32_t joint;
+        uint32_t timeOffset;
+        uint32_t keyOffset;
+        uint32_t samples;
+        Animation::Interpolation mode;
+        float origin[3];
+        float step[3];
+    };
+
+    CompressedAnimation(const Animation& animation,
+                        const CompressionSettings& settings = {});
+
+    CompressedAnimation(const CompressedAnimation&) = delete;
+    CompressedAnimation(CompressedAnimation&&) = default;
+
+    CompressedAnimation& operator=(const CompressedAnimation&) = delete;
+    CompressedAnimation& operator=(CompressedAnimation&&) = default;
+
+    const Track* tracks(Group group) const {
+        return reinterpret_cast<const Track*>(m_blob.get() + m_trackOffset) +
+               m_groupOffsets[group];
+    }
+    size_t trackCount(Group group) const {
+        return m_groupOffsets[group + 1] - m_groupOffsets[group];
+    }
+    const float* times() const {
+        return reinterpret_cast<const float*>(m_blob.get() + m_timeOffset);
+    }
+    const uint16_t* keys() const {
+        return reinterpret_cast<const uint16_t*>(m_blob.get() + m_keyOffset);
+    }
+
+    static glm::vec3 decodeVector(const Track& track, const uint16_t* key) {
+        return {track.origin[0] + key[0] * track.step[0],
+                track.origin[1] + key[1] * track.step[1],
+                track.origin[2] + key[2] * track.step[2]};
+    }
+    static glm::quat decodeRotation(const uint16_t* key);
+
+    static void encodeRotation(glm::quat rotation, uint16_t* key);
+
+    size_t jointCount() const { return m_jointCount; }
+    double duration() const { return m_duration; }
+    size_t keyCount() const { return m_keyCount; }
+    size_t byteSize() const { return m_byteSize; }
+
+   private:
+    using Interpolation = Animation::Interpolation;
+
+    template <typename Comp>
+    struct SourceTrack {
+        uint32_t joint;
+        Interpolation mode;
+        std::vector<float> times;
+        std::vector<Comp> keys;
+    };
+
+    struct BlobDeleter {
+        void operator()(std::byte* data) const {
+            ::operator delete(data, std::align_val_t{CACHE_LINE_SIZE});
+        }
+    };
+
+    template <typename Comp>
+    static SourceTrack<Comp> resample(
+        const Animation::AnimationBuffer<Comp>& buffer,
+        const Animation::BufferView& view, uint32_t joint,
+        uint32_t subdivisions);
+    template <typename Comp>
+    static void reduce(SourceTrack<Comp>& track, float error);
+    static void quantize(const SourceTrack<glm::vec3>& track, Track& output,
+                         uint16_t* keys);
+    static void quantize(const SourceTrack<glm::quat>& track, Track& output,
+                         uint16_t* keys);
+
+    std::unique_ptr<std::byte[], BlobDeleter> m_blob;
+    size_t m_byteSize{0};
+    size_t m_trackOffset{0};
+    size_t m_timeOffset{0};
+    size_t m_keyOffset{0};
+    size_t m_groupOffsets[GroupCount + 1]{};
+    size_t m_jointCount{0};
+    size_t m_keyCount{0};
+    double m_duration{0.0};
+};
+
+inline glm::quat CompressedAnimation::decodeRotation(const uint16_t* key) {
+    const float scale = 1.41421356f / 32767.0f;
+    const float bias = -0.70710678f;
+    auto bits = uint64_t{key[0]} | uint64_t{key[1]} << 16 |
+                uint64_t{key[2]} << 32;
+    auto a = static_cast<float>(bits & 0x7fff) * scale + bias;
+    auto b = static_cast<float>(bits >> 15 & 0x7fff) * scale + bias;
+    auto c = static_cast<float>(bits >> 30 & 0x7fff) * scale + bias;
+    auto d = std::sqrt(std::max(0.0f, 1.0f - a * a - b * b - c * c));
+    switch (bits >> 45) {
+        case 0:
+            return {d, a, b, c};
+        case 1:
+            return {a, d, b, c};
+        case 2:
+            return {a, b, d, c};
+        default:
+            return {a, b, c, d};
+    }
+}
+
+}  // namespace gltf
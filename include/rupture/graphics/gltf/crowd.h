@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rupture/graphics/gltf/skin.h"
+#include "rupture/thread_pool.h"
+
+namespace gltf {
+
+const size_t DEFAULT_CROWD_JOB_SIZE = 32;
+
+class CrowdAnimator {
+   public:
+    struct Instance {
+        const Skin* skin;
+        size_t animation;
+        float time;
+        glm::mat4 rootTransform;
+        float lodMetric;
+    };
+
+    // Instances on a level with an update interval N > 1 blend between
+    // their last two samples and so trail the animation by N - 1 frames.
+    struct LodLevel {
+        float maxMetric;
+        uint32_t updateInterval;
+        bool freezeLeaves;
+    };
+
+    explicit CrowdAnimator(size_t jobSize = DEFAULT_CROWD_JOB_SIZE)
+        : m_jobSize{jobSize} {}
+
+    CrowdAnimator(const CrowdAnimator&) = delete;
+    CrowdAnimator(CrowdAnimator&&) = default;
+
+    CrowdAnimator& operator=(const CrowdAnimator&) = delete;
+    CrowdAnimator& operator=(CrowdAnimator&&) = default;
+
+    size_t add(const Skin& skin, size_t animation, float time,
+               const glm::mat4& rootTransform, float lodMetric = 0.0f);
+    void clear();
+
+    void setLodLevels(std::vector<LodLevel> levels);
+    const std::vector<LodLevel>& lodLevels() const { return m_lodLevels; }
+
+    void update(ThreadPool& pool, glm::mat4* palettes, size_t capacity);
+
+    size_t instanceCount() const { return m_instances.size(); }
+    size_t paletteSize() const { return m_paletteSize; }
+    size_t paletteOffset(size_t instance) const {
+        return m_offsets.at(instance);
+    }
+
+   private:
+    struct LodState {
+        const Skin* skin{nullptr};
+        size_t animation{0};
+        uint32_t age{0};
+        PoseBuffer previous;
+        PoseBuffer next;
+        PoseBuffer pose;
+    };
+
+    LodLevel lodLevel(float metric) const;
+    void animate(size_t instance, glm::mat4* output);
+
+    std::vector<Instance> m_instances;
+    std::vector<size_t> m_offsets;
+    std::vector<Skin::Workspace> m_workspaces;
+    std::vector<LodState> m_lodStates;
+    std::vector<LodLevel> m_lodLevels;
+    size_t m_paletteSize{0};
+    size_t m_frame{0};
+    size_t m_jobSize;
+};
+
+}  // namespace gltf
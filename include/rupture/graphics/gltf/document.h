@@ -7,12 +7,14 @@
 #include <unordered_map>
 #include <vector>
 
+#include "rupture/graphics/gltf/accessor.h"
 #include "rupture/graphics/gltf/animation.h"
 #include "rupture/graphics/gltf/material.h"
 #include "rupture/graphics/gltf/mesh.h"
 #include "rupture/graphics/gltf/skin.h"
 #include "rupture/graphics/gltf/texture.h"
 #include "rupture/graphics/vertex.h"
+#include "rupture/thread_pool.h"
 #include "rupture/typemap.h"
 
 namespace gltf {
@@ -20,6 +22,9 @@ namespace gltf {
 class Document {
    public:
     Document(const std::filesystem::path& path);
+    Document(const std::filesystem::path& path, ThreadPool& pool);
+    Document(const std::filesystem::path& path,
+             const std::filesystem::path& cacheDirectory, ThreadPool& pool);
 
     Document(const Document&) = delete;
     Document(Document&&) = delete;
@@ -61,6 +66,8 @@ class Document {
     const std::string& name() const { return m_name; }
 
    private:
+    struct Import;
+
     struct NodeTransforms {
         std::vector<glm::mat4> globalTransform;
         std::vector<glm::mat4> inverseTransform;
@@ -71,14 +78,33 @@ class Document {
     NodeTransforms getNodeTransforms(const fx::gltf::Document& document);
 
     void loadDocument(const std::filesystem::path& path,
-                      const fx::gltf::Document& document);
+                      const fx::gltf::Document& document,
+                      const BufferTable& buffers, ThreadPool& pool);
     void loadMaterials(const std::filesystem::path& path,
-                       const fx::gltf::Document& document);
+                       const fx::gltf::Document& document,
+                       const BufferTable& buffers, ThreadPool& pool,
+                       TaskGroup& group, Import& import);
     void loadAnimations(const fx::gltf::Document& document,
-                        std::unordered_map<uint32_t, uint32_t>& skinMap);
+                        const BufferTable& buffers,
+                        std::unordered_map<uint32_t, uint32_t>& skinMap,
+                        ThreadPool& pool, TaskGroup& group, Import& import);
 
     void loadMeshes(const fx::gltf::Document& document,
-                    const std::unordered_map<uint32_t, uint32_t>& skinMap);
+                    const BufferTable& buffers,
+                    const std::unordered_map<uint32_t, uint32_t>& skinMap,
+                    ThreadPool& pool, TaskGroup& group, Import& import);
+    void finishImport(Import& import);
+
+    static std::filesystem::path cookedPath(
+        const std::filesystem::path& path,
+        const std::filesystem::path& cacheDirectory);
+    bool loadCooked(const std::filesystem::path& cooked,
+                    const std::filesystem::path& path, uint64_t sourceHash);
+    void writeCooked(const std::filesystem::path& cooked,
+                     const std::filesystem::path& path,
+                     const fx::gltf::Document& document,
+                     uint64_t sourceHash) const;
+    void reset();
 
     TypeMap<std::vector<Mesh<RigidVertex>>, std::vector<Mesh<SkinVertex>>,
             std::vector<Texture>, std::vector<pbrMaterial>, std::vector<Skin>>
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <fx/gltf.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "rupture/graphics/gltf/accessor.h"
+#include "rupture/mapped_file.h"
+
+namespace gltf {
+
+class MappedDocument {
+   public:
+    explicit MappedDocument(const std::filesystem::path& path);
+
+    MappedDocument(const MappedDocument&) = delete;
+    MappedDocument(MappedDocument&&) = default;
+
+    MappedDocument& operator=(const MappedDocument&) = delete;
+    MappedDocument& operator=(MappedDocument&&) = default;
+
+    const fx::gltf::Document& document() const { return m_document; }
+    const BufferTable& buffers() const { return m_buffers; }
+
+    template <typename T>
+    AccessorView<T> accessor(size_t index) const {
+        return accessorView<T>(m_document, m_buffers,
+                               m_document.accessors.at(index));
+    }
+
+   private:
+    struct Chunk {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    static Chunk binaryContainer(const MappedFile& file, Chunk& json);
+    void mapBuffers(const std::filesystem::path& root, Chunk binary);
+
+    std::vector<MappedFile> m_files;
+    fx::gltf::Document m_document;
+    BufferTable m_buffers;
+};
+
+}  // namespace gltf
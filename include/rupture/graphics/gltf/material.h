@@ -60,6 +60,7 @@ class pbrMaterial {
 
    private:
     friend class Scene;
+    friend class Document;
 
     static std::string getGltfUID(const std::filesystem::path& path,
                                   const fx::gltf::Document& document,
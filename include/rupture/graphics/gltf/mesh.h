@@ -45,12 +45,16 @@ class Mesh {
 
     Mesh(const fx::gltf::Document& document,
          const fx::gltf::Primitive& primitive)
+        : Mesh{document, BufferTable{document}, primitive} {};
+
+    Mesh(const fx::gltf::Document& document, const BufferTable& buffers,
+         const fx::gltf::Primitive& primitive)
         : m_mode{enum_integer(primitive.mode)} {
         if (primitive.indices != -1) {
             m_indices = loadIndexBuffer(
-                document, document.accessors.at(primitive.indices));
+                document, buffers, document.accessors.at(primitive.indices));
         }
-        m_vertices = loadVertices(document, primitive);
+        m_vertices = loadVertices(document, buffers, primitive);
     };
 
     Mesh(const Mesh&) = default;
@@ -88,15 +92,16 @@ class Mesh {
               typename std::enable_if<std::is_same<T, RigidVertex>::value,
                                       bool>::type = true>
     std::vector<Vert> loadVertices(const fx::gltf::Document& document,
+                                   const BufferTable& buffers,
                                    const fx::gltf::Primitive& primitive) {
         size_t size{};
-        auto posReader = gltf::requiredAttrib<glm::vec3>(document, primitive,
-                                                         "POSITION"s, size);
-        auto normReader =
-            gltf::optionalAttrib<glm::vec3>(document, primitive, "NORMAL"s);
+        auto posReader = gltf::requiredAttrib<glm::vec3>(
+            document, buffers, primitive, "POSITION"s, size);
+        auto normReader = gltf::optionalAttrib<glm::vec3>(document, buffers,
+                                                          primitive, "NORMAL"s);
 
-        auto tangReader =
-            gltf::optionalAttrib<glm::vec4>(document, primitive, "TANGENT"s);
+        auto tangReader = gltf::optionalAttrib<glm::vec4>(
+            document, buffers, primitive, "TANGENT"s);
 
         auto texReader = [&]() -> std::function<bool(glm::vec2&)> {
             size_t size{};
@@ -105,11 +110,12 @@ class Mesh {
                     gltf::attribCompType(document, primitive, "TEXCOORD_0"s)) {
                     case fx::gltf::Accessor::ComponentType::Float:
                         return gltf::requiredAttrib<glm::vec2>(
-                            document, primitive, "TEXCOORD_0"s, size);
+                            document, buffers, primitive, "TEXCOORD_0"s, size);
                     case fx::gltf::Accessor::ComponentType::UnsignedByte: {
                         auto accessor =
                             gltf::requiredAttrib<glm::vec2, glm::u8vec2>(
-                                document, primitive, "TEXCOORD_0"s, size);
+                                document, buffers, primitive, "TEXCOORD_0"s,
+                                size);
                         return [accessor](glm::vec2& item) mutable {
                             bool valid = accessor(item);
                             item /= std::numeric_limits<uint8_t>::max();
@@ -119,7 +125,8 @@ class Mesh {
                     case fx::gltf::Accessor::ComponentType::UnsignedShort: {
                         auto accessor =
                             gltf::requiredAttrib<glm::vec2, glm::u16vec2>(
-                                document, primitive, "TEXCOORD_0"s, size);
+                                document, buffers, primitive, "TEXCOORD_0"s,
+                                size);
                         return [accessor](glm::vec2& item) mutable {
                             bool valid = accessor(item);
                             item /= std::numeric_limits<uint16_t>::max();
@@ -149,15 +156,16 @@ class Mesh {
               typename std::enable_if<std::is_same<T, SkinVertex>::value,
                                       bool>::type = true>
     std::vector<Vert> loadVertices(const fx::gltf::Document& document,
+                                   const BufferTable& buffers,
                                    const fx::gltf::Primitive& primitive) {
         size_t size{};
-        auto posReader = gltf::requiredAttrib<glm::vec3>(document, primitive,
-                                                         "POSITION"s, size);
-        auto normReader =
-            gltf::optionalAttrib<glm::vec3>(document, primitive, "NORMAL"s);
+        auto posReader = gltf::requiredAttrib<glm::vec3>(
+            document, buffers, primitive, "POSITION"s, size);
+        auto normReader = gltf::optionalAttrib<glm::vec3>(document, buffers,
+                                                          primitive, "NORMAL"s);
 
-        auto tangReader =
-            gltf::optionalAttrib<glm::vec4>(document, primitive, "TANGENT"s);
+        auto tangReader = gltf::optionalAttrib<glm::vec4>(
+            document, buffers, primitive, "TANGENT"s);
 
         auto texReader = [&]() -> std::function<bool(glm::vec2&)> {
             size_t size{};
@@ -166,11 +174,12 @@ class Mesh {
                     gltf::attribCompType(document, primitive, "TEXCOORD_0"s)) {
                     case fx::gltf::Accessor::ComponentType::Float:
                         return gltf::requiredAttrib<glm::vec2>(
-                            document, primitive, "TEXCOORD_0"s, size);
+                            document, buffers, primitive, "TEXCOORD_0"s, size);
                     case fx::gltf::Accessor::ComponentType::UnsignedByte: {
                         auto accessor =
                             gltf::requiredAttrib<glm::vec2, glm::u8vec2>(
-                                document, primitive, "TEXCOORD_0"s, size);
+                                document, buffers, primitive, "TEXCOORD_0"s,
+                                size);
                         return [accessor](glm::vec2& item) mutable {
                             bool valid = accessor(item);
                             item /= std::numeric_limits<uint8_t>::max();
@@ -180,7 +189,8 @@ class Mesh {
                     case fx::gltf::Accessor::ComponentType::UnsignedShort: {
                         auto accessor =
                             gltf::requiredAttrib<glm::vec2, glm::u16vec2>(
-                                document, primitive, "TEXCOORD_0"s, size);
+                                document, buffers, primitive, "TEXCOORD_0"s,
+                                size);
                         return [accessor](glm::vec2& item) mutable {
                             bool valid = accessor(item);
                             item /= std::numeric_limits<uint16_t>::max();
@@ -200,10 +210,10 @@ class Mesh {
             switch (gltf::attribCompType(document, primitive, "JOINTS_0"s)) {
                 case fx::gltf::Accessor::ComponentType::UnsignedByte:
                     return gltf::requiredAttrib<glm::uvec4, glm::u8vec4>(
-                        document, primitive, "JOINTS_0"s, size);
+                        document, buffers, primitive, "JOINTS_0"s, size);
                 case fx::gltf::Accessor::ComponentType::UnsignedShort:
                     return gltf::requiredAttrib<glm::uvec4, glm::u16vec4>(
-                        document, primitive, "JOINTS_0"s, size);
+                        document, buffers, primitive, "JOINTS_0"s, size);
                 default:
                     throw std::runtime_error("Invalid gltf component type");
             };
@@ -213,12 +223,12 @@ class Mesh {
             size_t size{};
             switch (gltf::attribCompType(document, primitive, "WEIGHTS_0"s)) {
                 case fx::gltf::Accessor::ComponentType::Float:
-                    return gltf::requiredAttrib<glm::vec4>(document, primitive,
-                                                           "WEIGHTS_0"s, size);
+                    return gltf::requiredAttrib<glm::vec4>(
+                        document, buffers, primitive, "WEIGHTS_0"s, size);
                 case fx::gltf::Accessor::ComponentType::UnsignedByte: {
                     auto accessor =
                         gltf::requiredAttrib<glm::vec4, glm::u8vec4>(
-                            document, primitive, "WEIGHTS_0"s, size);
+                            document, buffers, primitive, "WEIGHTS_0"s, size);
                     return [accessor](glm::vec4& item) mutable {
                         bool valid = accessor(item);
                         item /= std::numeric_limits<uint8_t>::max();
@@ -228,7 +238,7 @@ class Mesh {
                 case fx::gltf::Accessor::ComponentType::UnsignedShort: {
                     auto accessor =
                         gltf::requiredAttrib<glm::vec4, glm::u16vec4>(
-                            document, primitive, "WEIGHTS_0"s, size);
+                            document, buffers, primitive, "WEIGHTS_0"s, size);
                     return [accessor](glm::vec4& item) mutable {
                         bool valid = accessor(item);
                         item /= std::numeric_limits<uint16_t>::max();
@@ -253,18 +263,20 @@ class Mesh {
     }
 
     std::vector<uint32_t> loadIndexBuffer(const fx::gltf::Document& document,
+                                          const BufferTable& buffers,
                                           const fx::gltf::Accessor& accessor) {
         switch (accessor.componentType) {
             case fx::gltf::Accessor::ComponentType::UnsignedInt: {
-                return gltf::readContiguous<uint32_t>(document, accessor);
+                return gltf::readContiguous<uint32_t>(document, buffers,
+                                                      accessor);
             }
             case fx::gltf::Accessor::ComponentType::UnsignedShort: {
-                return gltf::readContiguous<uint32_t, uint16_t>(document,
-                                                                accessor);
+                return gltf::readContiguous<uint32_t, uint16_t>(
+                    document, buffers, accessor);
             }
             case fx::gltf::Accessor::ComponentType::UnsignedByte: {
-                return gltf::readContiguous<uint32_t, uint8_t>(document,
-                                                               accessor);
+                return gltf::readContiguous<uint32_t, uint8_t>(
+                    document, buffers, accessor);
             }
             default:
                 throw std::runtime_error("Invalid gltf component type");
@@ -4,21 +4,35 @@
 
 #include <fx/gltf.h>
 
+#include <array>
 #include <filesystem>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <stack>
+#include <stdexcept>
 #include <unordered_map>
 #include <vector>
 
+#include "rupture/graphics/gltf/accessor.h"
 #include "rupture/graphics/gltf/animation.h"
+#include "rupture/graphics/gltf/animation_sampler.h"
+#include "rupture/graphics/gltf/compressed_animation.h"
 
 namespace gltf {
 
 class Skin {
    public:
     Skin(const fx::gltf::Document& document, const fx::gltf::Skin& skin,
+         const std::unordered_map<uint32_t, uint32_t>& parentMap,
+         const std::vector<glm::mat4>& globalTransforms,
+         const std::vector<glm::mat4>& inverseTransforms)
+        : Skin{document, BufferTable{document}, skin, parentMap,
+               globalTransforms, inverseTransforms} {}
+    Skin(const fx::gltf::Document& document, const BufferTable& buffers,
+         const fx::gltf::Skin& skin,
          const std::unordered_map<uint32_t, uint32_t>& parentMap,
          const std::vector<glm::mat4>& globalTransforms,
          const std::vector<glm::mat4>& inverseTransforms);
@@ -29,24 +43,53 @@ class Skin {
     Skin& operator=(const Skin&) = default;
     Skin& operator=(Skin&&) = default;
 
+    class Workspace {
+       public:
+        Workspace() = default;
+
+       private:
+        friend Skin;
+
+        AnimationSampler::Cursor m_cursor;
+        AnimationSampler::Cursor m_rootCursor;
+        PoseBuffer m_pose;
+        PoseBuffer m_rootPose;
+        std::vector<glm::mat4x3> m_transforms;
+    };
+
+    struct RootMotion {
+        glm::vec3 translation{0.0f};
+        glm::quat rotation{0.0f, 0.0f, 0.0f, 1.0f};
+    };
+
     std::vector<glm::mat4> jointMatrices(const glm::mat4& rootTransform,
                                          size_t animation, float time) const {
         std::vector<glm::mat4> result(m_joints.size(), glm::mat4{1.0f});
-        auto jointTransforms = m_animations[animation].getJointTransforms(time);
-
-        for (size_t i{0}; i < m_joints.size(); i++) {
-            auto& joint = m_joints[i];
-            for (size_t j{0}; j < joint.numChildren; j++) {
-                jointTransforms[joint.firstChild + j] =
-                    jointTransforms[i] * jointTransforms[joint.firstChild + j];
-            }
-            result[m_skinIndexJointMap.at(joint.nodeId)] =
-                m_rootTransform * jointTransforms[i] * joint.inverseBind;
-        }
-
+        Workspace workspace{};
+        jointMatrices(rootTransform, animation, time, workspace, result.data());
         return result;
     };
 
+    void jointMatrices(const glm::mat4& rootTransform, size_t animation,
+                       float time, Workspace& workspace, glm::mat4* output,
+                       bool freezeLeaves = false) const;
+
+    void samplePose(size_t animation, float time, Workspace& workspace,
+                    const PoseView& pose, bool freezeLeaves = false) const;
+    void poseMatrices(const glm::mat4& rootTransform, const PoseView& pose,
+                      Workspace& workspace, glm::mat4* output) const;
+
+    template <size_t Size>
+    void jointMatrices(const glm::mat4& rootTransform, size_t animation,
+                       float time, Workspace& workspace,
+                       std::array<glm::mat4, Size>& output) const {
+        if (Size < m_joints.size()) {
+            throw std::out_of_range("Joint palette too small for skin");
+        }
+        jointMatrices(rootTransform, animation, time, workspace,
+                      output.data());
+    }
+
     std::vector<glm::mat4> bindPose() const {
         std::vector<glm::mat4> result(m_joints.size(), glm::mat4{1.0f});
         auto bindPose = getBindPose();
@@ -65,14 +108,42 @@ class Skin {
     };
 
     double animationDuration(size_t animation) const {
-        return m_animations[animation].duration();
+        return m_samplers.at(animation).duration();
+    }
+
+    size_t animationIndex(const std::string& name) const {
+        auto it = m_animationMap.find(name);
+        if (it == m_animationMap.end()) {
+            throw std::out_of_range("Unknown animation " + name);
+        }
+        return it->second;
     }
 
+    size_t animationCount() const { return m_animations.size(); }
+
+    const AnimationSampler& sampler(size_t animation) const {
+        return m_samplers.at(animation);
+    }
+
+    void compressAnimations(const CompressionSettings& settings = {});
+
+    RootMotion rootMotion(size_t animation, float from, float to,
+                          Workspace& workspace) const;
+    void removeRootMotion(size_t animation, const PoseView& pose,
+                          Workspace& workspace) const;
+
+    void restPose(const PoseView& pose) const;
+    std::vector<float> boneMask(const std::string& jointName) const;
+
+    size_t jointCount() const { return m_joints.size(); }
+
    private:
     friend class Scene;
     friend class Document;
     friend class AnimParserHelper;
 
+    Skin() = default;
+
     static std::string getGltfUID(const std::filesystem::path& path,
                                   const fx::gltf::Document& document,
                                   size_t skinIndex);
@@ -85,11 +156,25 @@ class Skin {
     }
 
     void registerAnimation(std::string name, const fx::gltf::Document& document,
+                           const BufferTable& buffers,
                            const fx::gltf::Animation& animation) {
-        m_animations.emplace_back(document, animation, m_meshNodeIndexMap);
-        m_animationMap.emplace(std::move(name), m_animations.size());
+        registerAnimation(std::move(name), std::make_shared<const Animation>(
+                                              document, buffers, animation,
+                                              m_meshNodeIndexMap));
     };
 
+    void registerAnimation(std::string name,
+                           std::shared_ptr<const Animation> animation) {
+        m_animations.push_back(std::move(animation));
+        m_samplers.emplace_back(*m_animations.back());
+        registerSampler(m_samplers.size() - 1);
+        m_animationMap.emplace(std::move(name), m_animations.size() - 1);
+    };
+
+    void registerSampler(size_t animation);
+    RootMotion rootTransform(size_t animation, float time,
+                             Workspace& workspace) const;
+
     std::vector<glm::mat4> getBindPose() const {
         std::vector<glm::mat4> bindPose;
         bindPose.reserve(m_joints.size());
@@ -101,6 +186,9 @@ class Skin {
         return bindPose;
     }
 
+    static constexpr uint32_t NO_PARENT =
+        std::numeric_limits<uint32_t>::max();
+
     struct Joint {
         glm::mat4 inverseBind;
         glm::quat r;
@@ -114,7 +202,13 @@ class Skin {
 
     glm::mat4 m_rootTransform;
     std::vector<Joint> m_joints;
-    std::vector<Animation> m_animations;
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_skinIndices;
+    std::vector<glm::mat4x3> m_inverseBinds;
+    std::vector<std::shared_ptr<const Animation>> m_animations;
+    std::vector<AnimationSampler> m_samplers;
+    std::vector<AnimationSampler> m_leafFrozenSamplers;
+    std::vector<AnimationSampler> m_rootSamplers;
     std::unordered_map<std::string, size_t> m_animationMap;
     std::unordered_map<uint32_t, uint32_t> m_meshNodeIndexMap;
     std::unordered_map<uint32_t, uint32_t> m_skinIndexJointMap;
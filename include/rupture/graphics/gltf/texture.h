@@ -3,9 +3,12 @@
 
 #include <fx/gltf.h>
 
+#include <algorithm>
 #include <filesystem>
 #include <vector>
 
+#include "rupture/graphics/gltf/accessor.h"
+
 namespace gltf {
 
 class Texture {
@@ -21,7 +24,11 @@ class Texture {
             Format format = Format::RGBA);
     Texture(const std::filesystem::path& path, Format format = Format::RGBA);
     Texture(const std::filesystem::path& path,
-            const fx::gltf::Document& document, const fx::gltf::Image& image);
+            const fx::gltf::Document& document, const fx::gltf::Image& image)
+        : Texture{path, document, BufferTable{document}, image} {}
+    Texture(const std::filesystem::path& path,
+            const fx::gltf::Document& document, const BufferTable& buffers,
+            const fx::gltf::Image& image);
 
     Texture(const Texture&) = default;
     Texture(Texture&&) = default;
@@ -31,16 +38,31 @@ class Texture {
 
     static Texture null() { return Texture(1, 1, Format::RGBA); };
 
+    void generateMipmaps();
+
     const std::vector<uint8_t>& data() const { return m_imageData; }
+    const uint8_t* mipData(size_t level) const {
+        return m_imageData.data() + mipOffset(level);
+    }
 
     size_t width() const { return m_width; }
     size_t height() const { return m_height; }
+    size_t mipWidth(size_t level) const {
+        return std::max<size_t>(m_width >> level, 1);
+    }
+    size_t mipHeight(size_t level) const {
+        return std::max<size_t>(m_height >> level, 1);
+    }
+    size_t mipLevels() const { return m_mipLevels; }
     Format format() const { return m_format; }
 
    private:
     friend class Scene;
+    friend class Document;
     friend class pbrMaterial;
 
+    size_t mipOffset(size_t level) const;
+
     static std::string getGltfUID(const std::filesystem::path& path,
                                   const fx::gltf::Document& document,
                                   uint32_t index);
@@ -52,6 +74,7 @@ class Texture {
     Format m_format;
     size_t m_width;
     size_t m_height;
+    size_t m_mipLevels{1};
 };
 
 class HDRTexture {
@@ -9,6 +9,8 @@
 #include <type_traits>
 #include <vector>
 
+#include "rupture/graphics/gltf/accessor.h"
+
 using namespace std::string_literals;
 
 namespace gltf {
@@ -32,32 +34,19 @@ struct Type;
 
 template <typename Target, typename Source = Target>
 std::function<bool(Target&)> reader(const fx::gltf::Document& document,
+                                    const BufferTable& buffers,
                                     const fx::gltf::Accessor& accessor) {
     static_assert(std::is_pod<Target>::value && std::is_pod<Source>::value &&
                   std::is_assignable<Target, Source>::value);
     if (accessor.type != Type<Target>::type) {
         throw std::invalid_argument("Invalid accessor for type"s);
     }
-    const auto& bufferView = document.bufferViews.at(accessor.bufferView);
-    const auto& buffer = document.buffers.at(bufferView.buffer);
-    const size_t count{accessor.count};
-
-    size_t offset = bufferView.byteOffset + accessor.byteOffset;
-    size_t stride =
-        bufferView.byteStride ? bufferView.byteStride : sizeof(Source);
+    auto view = accessorView<Source>(document, buffers, accessor);
     size_t element = 0;
 
     return [=](Target& item) mutable {
-        if (element < count) {
-            if constexpr (std::is_same<Target, Source>::value) {
-                std::memcpy(&item, &buffer.data[offset + stride * element++],
-                            sizeof(Source));
-            } else {
-                Source tmp{};
-                std::memcpy(&tmp, &buffer.data[offset + stride * element++],
-                            sizeof(Source));
-                item = tmp;
-            }
+        if (element < view.size()) {
+            item = view[element++];
             return true;
         } else {
             return false;
@@ -65,63 +54,68 @@ std::function<bool(Target&)> reader(const fx::gltf::Document& document,
     };
 }
 
+template <typename Target, typename Source = Target>
+std::function<bool(Target&)> reader(const fx::gltf::Document& document,
+                                    const fx::gltf::Accessor& accessor) {
+    return reader<Target, Source>(document, BufferTable{document}, accessor);
+}
+
 template <typename Target, typename Source = Target>
 std::function<bool(Target&)> requiredAttrib(
-    const fx::gltf::Document& document, const fx::gltf::Primitive& primitive,
-    const std::string& attrib, size_t& size) {
+    const fx::gltf::Document& document, const BufferTable& buffers,
+    const fx::gltf::Primitive& primitive, const std::string& attrib,
+    size_t& size) {
     auto item = primitive.attributes.at(attrib);
     const auto& accessor = document.accessors[item];
     size = accessor.count;
-    return reader<Target, Source>(document, accessor);
+    return reader<Target, Source>(document, buffers, accessor);
 }
 
 template <typename Target, typename Source = Target>
 std::function<bool(Target&)> optionalAttrib(
-    const fx::gltf::Document& document, const fx::gltf::Primitive& primitive,
-    const std::string& attrib) {
+    const fx::gltf::Document& document, const BufferTable& buffers,
+    const fx::gltf::Primitive& primitive, const std::string& attrib) {
     auto item = primitive.attributes.find(attrib);
     if (item != primitive.attributes.end()) {
         const auto& accessor = document.accessors[item->second];
-        return reader<Target, Source>(document, accessor);
+        return reader<Target, Source>(document, buffers, accessor);
     }
     return [](Target&) { return true; };
 }
 
 template <typename Target, typename Source = Target>
 std::vector<Target> readContiguous(const fx::gltf::Document& document,
+                                   const BufferTable& buffers,
                                    const fx::gltf::Accessor& accessor) {
     static_assert(std::is_pod<Target>::value && std::is_pod<Source>::value);
-    // static_assert(std::is_pod<Target>::value && std::is_pod<Source>::value &&
-    //               std::is_assignable<Target, Source>::value);
     if (accessor.type != Type<Target>::type) {
         throw std::invalid_argument("Invalid accessor for type"s);
     }
 
     const auto& bufferView = document.bufferViews.at(accessor.bufferView);
-    const auto& buffer = document.buffers.at(bufferView.buffer);
-    const size_t count{accessor.count};
-
     if (bufferView.byteStride != 0) {
         throw std::invalid_argument("Accessor refers to non contiguous data"s);
     }
 
-    size_t offset = bufferView.byteOffset + accessor.byteOffset;
-
-    std::vector<Target> target(count);
+    auto view = accessorView<Source>(document, buffers, accessor);
+    std::vector<Target> target(view.size());
     if constexpr (std::is_same<Target, Source>::value) {
-        std::memcpy(target.data(), &buffer.data[offset],
-                    sizeof(Target) * count);
+        view.copy(target.data());
     } else {
-        std::vector<Source> source(count);
-        std::memcpy(source.data(), &buffer.data[offset],
-                    sizeof(Source) * count);
-        for (size_t i{0}; i < count; i++) {
-            target[i] = source[i];
+        for (size_t i{0}; i < view.size(); i++) {
+            target[i] = view[i];
         }
     }
     return target;
 }
 
+template <typename Target, typename Source = Target>
+std::vector<Target> readContiguous(const fx::gltf::Document& document,
+                                   const fx::gltf::Accessor& accessor) {
+    return readContiguous<Target, Source>(document, BufferTable{document},
+                                          accessor);
+}
+
 template <>
 struct Type<glm::vec2> {
     static constexpr fx::gltf::Accessor::Type type =
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+
+const size_t DEFAULT_PALETTE_REGIONS = 3;
+
+class PaletteRing {
+   public:
+    explicit PaletteRing(size_t regionCapacity,
+                         size_t regionCount = DEFAULT_PALETTE_REGIONS)
+        : m_regionCapacity{regionCapacity}, m_regionCount{regionCount} {
+        if (m_regionCount == 0) {
+            throw std::logic_error("Palette ring needs at least one region");
+        }
+    }
+
+    PaletteRing(const PaletteRing&) = default;
+    PaletteRing(PaletteRing&&) = default;
+
+    PaletteRing& operator=(const PaletteRing&) = default;
+    PaletteRing& operator=(PaletteRing&&) = default;
+
+    size_t beginFrame() {
+        m_region = (m_region + 1) % m_regionCount;
+        m_used = 0;
+        return m_region;
+    }
+
+    size_t allocate(size_t count) {
+        if (m_used + count > m_regionCapacity) {
+            throw std::out_of_range("Palette ring region exhausted");
+        }
+        auto offset = regionOffset(m_region) + m_used;
+        m_used += count;
+        return offset;
+    }
+
+    size_t regionOffset(size_t region) const {
+        return region * m_regionCapacity;
+    }
+
+    size_t region() const { return m_region; }
+    size_t used() const { return m_used; }
+    size_t regionCapacity() const { return m_regionCapacity; }
+    size_t regionCount() const { return m_regionCount; }
+    size_t capacity() const { return m_regionCapacity * m_regionCount; }
+
+   private:
+    size_t m_regionCapacity;
+    size_t m_regionCount;
+    size_t m_region{0};
+    size_t m_used{0};
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <vector>
 
@@ -23,6 +24,11 @@ struct DebugVertex {
     glm::vec3 pos;
 };
 
+struct SkinInstance {
+    glm::mat4 model;
+    uint32_t paletteOffset;
+};
+
 struct DebugInstance {
     glm::vec3 color;
     glm::mat4 model;
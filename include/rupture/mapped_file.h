@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+class MappedFile {
+   public:
+    explicit MappedFile(const std::filesystem::path& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+   private:
+    void release();
+
+    const uint8_t* m_data{nullptr};
+    size_t m_size{0};
+    bool m_mapped{false};
+    std::vector<uint8_t> m_fallback;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+const size_t DEFAULT_PROFILER_CAPACITY = 16 * 1024;
+
+class Profiler {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Timeline {
+        Cpu,
+        Gpu,
+    };
+
+    struct Sample {
+        const char* name;
+        Timeline timeline;
+        uint32_t thread;
+        uint64_t frame;
+        int64_t begin;
+        int64_t duration;
+    };
+
+    class Scope {
+       public:
+        Scope(Profiler* profiler, const char* name)
+            : m_profiler{profiler},
+              m_name{name},
+              m_begin{profiler ? profiler->now() : 0} {}
+
+        Scope(const Scope&) = delete;
+        Scope(Scope&&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+        Scope& operator=(Scope&&) = delete;
+
+        ~Scope() {
+            if (m_profiler) {
+                m_profiler->record(m_name, m_begin, m_profiler->now());
+            }
+        }
+
+       private:
+        Profiler* m_profiler;
+        const char* m_name;
+        int64_t m_begin;
+    };
+
+    explicit Profiler(size_t capacity = DEFAULT_PROFILER_CAPACITY);
+
+    Profiler(const Profiler&) = delete;
+    Profiler(Profiler&&) = delete;
+
+    Profiler& operator=(const Profiler&) = delete;
+    Profiler& operator=(Profiler&&) = delete;
+
+    int64_t now() const;
+    void record(const char* name, int64_t begin, int64_t end);
+    void record(const Sample& sample);
+
+    void beginFrame() { m_frame.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t frame() const { return m_frame.load(std::memory_order_relaxed); }
+
+    std::vector<Sample> samples() const;
+    size_t size() const;
+    size_t capacity() const { return m_samples.size(); }
+    void clear();
+
+    void writeChromeTrace(std::ostream& out) const;
+    void writeChromeTrace(const std::filesystem::path& path) const;
+
+   private:
+    uint32_t threadIndex();
+
+    Clock::time_point m_epoch;
+    std::atomic<uint64_t> m_frame{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<Sample> m_samples;
+    size_t m_next{0};
+    size_t m_count{0};
+    std::vector<std::thread::id> m_threads;
+};
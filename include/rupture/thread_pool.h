@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool;
+
+class TaskGroup {
+   public:
+    TaskGroup() = default;
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup(TaskGroup&&) = delete;
+
+    TaskGroup& operator=(const TaskGroup&) = delete;
+    TaskGroup& operator=(TaskGroup&&) = delete;
+
+    bool done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+   private:
+    friend ThreadPool;
+
+    std::atomic<size_t> m_pending{0};
+    std::mutex m_errorMutex;
+    std::exception_ptr m_error;
+};
+
+class ThreadPool {
+   public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t workerCount = defaultWorkerCount());
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    ~ThreadPool();
+
+    void submit(TaskGroup& group, Task task);
+    void wait(TaskGroup& group);
+    bool runOne();
+
+    template <typename Func>
+    void parallelFor(size_t count, size_t grainSize, Func&& func) {
+        grainSize = std::max<size_t>(grainSize, 1);
+        TaskGroup group{};
+        for (size_t begin{0}; begin < count; begin += grainSize) {
+            auto end = std::min(begin + grainSize, count);
+            submit(group, [&func, begin, end]() { func(begin, end); });
+        }
+        wait(group);
+    }
+
+    size_t workerCount() const { return m_threads.size(); }
+    size_t threadIndex() const;
+
+    static size_t defaultWorkerCount() {
+        auto hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+   private:
+    struct Job {
+        Task task;
+        TaskGroup* group;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(size_t index);
+    bool tryRunOne(size_t index);
+    bool pop(size_t index, Job& job);
+    bool steal(size_t thief, Job& job);
+    void execute(Job& job);
+    size_t localQueue() const;
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeup;
+    std::atomic<size_t> m_queued{0};
+    std::atomic<size_t> m_nextQueue{0};
+    bool m_stop{false};
+};
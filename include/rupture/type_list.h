@@ -0,0 +1,233 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+template <typename... Types>
+struct Read {};
+
+template <typename... Types>
+struct Write {};
+
+template <typename... Types>
+struct TypeList {
+    static constexpr size_t size = sizeof...(Types);
+};
+
+template <typename U, typename... Types>
+struct ContainsType {
+    static constexpr bool value = (std::is_same_v<U, Types> || ...);
+};
+
+template <typename U, typename List>
+struct ListContainsType;
+
+template <typename U, template <typename...> class List, typename... Types>
+struct ListContainsType<U, List<Types...>> : ContainsType<U, Types...> {};
+
+template <typename... Lists>
+struct ConcatTypeLists {
+    using type = TypeList<>;
+};
+
+template <template <typename...> class List, typename... Types>
+struct ConcatTypeLists<List<Types...>> {
+    using type = TypeList<Types...>;
+};
+
+template <template <typename...> class First, typename... Types1,
+          template <typename...> class Second, typename... Types2,
+          typename... Rest>
+struct ConcatTypeLists<First<Types1...>, Second<Types2...>, Rest...> {
+    using type =
+        typename ConcatTypeLists<TypeList<Types1..., Types2...>, Rest...>::type;
+};
+
+template <typename List, typename... Types>
+struct AppendUniqueTypes {
+    using type = List;
+};
+
+template <typename... Listed, typename U, typename... Types>
+struct AppendUniqueTypes<TypeList<Listed...>, U, Types...> {
+    using type = typename AppendUniqueTypes<
+        std::conditional_t<ContainsType<U, Listed...>::value,
+                           TypeList<Listed...>, TypeList<Listed..., U>>,
+        Types...>::type;
+};
+
+template <typename List>
+struct UniqueTypes;
+
+template <template <typename...> class List, typename... Types>
+struct UniqueTypes<List<Types...>> {
+    using type = typename AppendUniqueTypes<TypeList<>, Types...>::type;
+};
+
+template <template <typename> class Predicate, typename List>
+struct FilterTypes;
+
+template <template <typename> class Predicate,
+          template <typename...> class List, typename... Types>
+struct FilterTypes<Predicate, List<Types...>> {
+    using type = typename ConcatTypeLists<
+        TypeList<>, std::conditional_t<Predicate<Types>::value, TypeList<Types>,
+                                       TypeList<>>...>::type;
+};
+
+template <template <typename...> class Target, typename List>
+struct RebindTypes;
+
+template <template <typename...> class Target,
+          template <typename...> class List, typename... Types>
+struct RebindTypes<Target, List<Types...>> {
+    using type = Target<Types...>;
+};
+
+template <typename... Types>
+class UniqueTypeList;
+
+template <typename U, typename... Types>
+class UniqueTypeList<U, Types...> {
+   public:
+    template <typename T>
+    constexpr const T& get() const {
+        return getInner<T>();
+    }
+
+    template <typename T>
+    constexpr T& get() {
+        return getInner<T>();
+    }
+
+   private:
+    template <typename T>
+    constexpr T& getInner() {
+        if constexpr (std::is_same_v<U, T>) {
+            return head;
+        } else {
+            return tail.template get<T>();
+        }
+    }
+
+    U head;
+    UniqueTypeList<Types...> tail;
+};
+
+template <>
+class UniqueTypeList<> {};
+
+template <typename U>
+class UniqueTypeList<U> {
+   public:
+    template <typename T>
+    constexpr const T& get() const {
+        return getInner<T>();
+    }
+
+    template <typename T>
+    constexpr T& get() {
+        return getInner<T>();
+    }
+
+   private:
+    template <typename T>
+    constexpr T& getInner() {
+        constexpr bool isSame = std::is_same_v<U, T>;
+        if constexpr (isSame) {
+            return head;
+        } else {
+            static_assert(isSame, "Type not found in UniqueTypeList");
+        }
+    }
+
+    U head;
+};
+
+template <typename... Views>
+class ListView;
+
+template <typename V, typename... Views>
+class ListView<V, Views...> {
+   public:
+    template <typename List>
+    constexpr ListView(List& list)
+        : head(list.template get<std::remove_const_t<V>>()),
+          tail(ListView<Views...>{list}) {}
+
+    template <typename T>
+    constexpr auto& get() const {
+        if constexpr (std::is_same_v<std::remove_const_t<T>,
+                                     std::remove_const_t<V>>) {
+            return head;
+        } else {
+            return tail.template get<T>();
+        }
+    }
+
+   private:
+    V& head;
+    ListView<Views...> tail;
+};
+
+template <typename V>
+class ListView<V> {
+   public:
+    template <typename List>
+    constexpr ListView(List& list)
+        : head(list.template get<std::remove_const_t<V>>()) {}
+
+    template <typename T>
+    constexpr auto& get() const {
+        constexpr bool isSame =
+            std::is_same_v<std::remove_const_t<T>, std::remove_const_t<V>>;
+        static_assert(isSame, "Type not found in ListView");
+        return head;
+    }
+
+   private:
+    V& head;
+};
+
+template <typename U, typename... T>
+constexpr auto make_uniqueTypeListBuilder();
+
+template <typename... Types>
+class UniqueTypeListBuilder {
+   public:
+    using TypeList = UniqueTypeList<Types...>;
+
+    constexpr TypeList build() const { return TypeList{}; }
+
+   private:
+    template <typename U, typename... T>
+    friend constexpr auto make_uniqueTypeListBuilder();
+
+    template <typename U>
+    constexpr auto pushType() const {
+        if constexpr (ContainsType<U, Types...>::value) {
+            return *this;
+        } else {
+            return UniqueTypeListBuilder<U, Types...>{};
+        }
+    }
+};
+
+template <typename U, typename... Types>
+constexpr auto make_uniqueTypeListBuilder() {
+    if constexpr (sizeof...(Types) == 0) {
+        return UniqueTypeListBuilder<U>{};
+    } else {
+        UniqueTypeListBuilder typeList{make_uniqueTypeListBuilder<Types...>()};
+        return typeList.template pushType<U>();
+    }
+}
+
+template <typename... Types>
+using UniqueTypeListType =
+    decltype(make_uniqueTypeListBuilder<Types...>().build());
+
+template <typename... Types1, typename... Types2>
+constexpr auto operator+(UniqueTypeList<Types1...>, UniqueTypeList<Types2...>) {
+    return make_uniqueTypeListBuilder<Types1..., Types2...>().build();
+}
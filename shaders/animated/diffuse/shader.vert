@@ -2,8 +2,6 @@
 
 #extension GL_ARB_shader_draw_parameters : require
 
-const uint MAX_JOIN_MATRICES = 20;
-
 // VERTEX ATTRIBUTES
 layout(location = 0) in vec3 pos;
 layout(location = 1) in vec3 norm;
@@ -14,6 +12,7 @@ layout(location = 5) in vec2 tex;
 
 // INSTANCE ATTRIBUTES
 layout(location = 6) in mat4 model;
+layout(location = 10) in uint palette_offset;
 
 out VS_OUT {
     vec3 norm;
@@ -25,7 +24,7 @@ vs_out;
 
 uniform mat4 proj_view;
 
-layout(std140) uniform JointMatrices { mat4 joint[MAX_JOIN_MATRICES]; }
+layout(std430, binding = 0) readonly buffer JointMatrices { mat4 joint[]; }
 joint_matrices;
 
 void main() {
@@ -34,9 +33,9 @@ void main() {
     vs_out.tex = tex;
     vs_out.draw_id = gl_DrawID;
     mat4 skin_matrix = 
-          weights.x * joint_matrices.joint[joints.x] 
-        + weights.y * joint_matrices.joint[joints.y] 
-        + weights.z * joint_matrices.joint[joints.z] 
-        + weights.w * joint_matrices.joint[joints.w];
+          weights.x * joint_matrices.joint[palette_offset + joints.x] 
+        + weights.y * joint_matrices.joint[palette_offset + joints.y] 
+        + weights.z * joint_matrices.joint[palette_offset + joints.z] 
+        + weights.w * joint_matrices.joint[palette_offset + joints.w];
     gl_Position = proj_view * model * skin_matrix * vec4(pos, 1.0);
 };
@@ -47,9 +47,18 @@ void Application::run() {
         m_window.handleInput(dTime);
 
         m_context.beginFrame();
-        draw(m_context, dTime);
+        {
+            auto& profiler = m_context.profiler();
+            Profiler::Scope cpuScope{&profiler, "Application::draw"};
+            gl::GpuTimer::Scope gpuScope{&m_context.gpuTimer(),
+                                         "Application::draw"};
+            draw(m_context, dTime);
+        }
         m_context.endFrame();
 
-        update(dTime);
+        {
+            Profiler::Scope scope{&m_context.profiler(), "Application::update"};
+            update(dTime);
+        }
     }
 }
@@ -0,0 +1,303 @@
+#include "rupture/ecs/transform.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+
+template <typename Column>
+void gather(Column& column, const std::vector<uint32_t>& order) {
+    Column result{};
+    result.reserve(order.size());
+    for (auto index : order) {
+        result.push_back(column[index]);
+    }
+    column = std::move(result);
+}
+
+}  // namespace
+
+glm::mat4 Transform::matrix() const {
+    auto rotationMatrix = glm::mat3_cast(rotation);
+    glm::mat4 result{1.0f};
+    result[0] = glm::vec4{rotationMatrix[0] * scale.x, 0.0f};
+    result[1] = glm::vec4{rotationMatrix[1] * scale.y, 0.0f};
+    result[2] = glm::vec4{rotationMatrix[2] * scale.z, 0.0f};
+    result[3] = glm::vec4{translation, 1.0f};
+    return result;
+}
+
+TransformHierarchy::Node TransformHierarchy::create(const Transform& local,
+                                                    Node parent) {
+    auto index = static_cast<uint32_t>(m_nodes.size());
+    auto parentIndex = parent == Node::null() ? NONE : position(parent);
+    if (parentIndex != NONE && !m_unsorted) {
+        m_unsorted = parentIndex + m_subtreeSizes[parentIndex] != index;
+    }
+
+    auto node = m_positions.insert(index);
+    m_nodes.push_back(node);
+    m_parents.push_back(parentIndex);
+    m_subtreeSizes.push_back(1);
+    m_translations.push_back(local.translation);
+    m_rotations.push_back(local.rotation);
+    m_scales.push_back(local.scale);
+    m_world.emplace_back(1.0f);
+    m_dirty.push_back(1);
+    m_anyDirty = true;
+
+    if (parentIndex != NONE && !m_unsorted) {
+        growAncestors(parentIndex);
+    }
+    return node;
+}
+
+void TransformHierarchy::destroy(Node node) {
+    if (m_unsorted) {
+        sort();
+    }
+    auto begin = position(node);
+    auto end = begin + m_subtreeSizes[begin];
+    for (auto i{begin}; i < end; i++) {
+        m_positions.remove(m_nodes[i]);
+        m_nodes[i] = Node::null();
+    }
+    m_unsorted = true;
+}
+
+void TransformHierarchy::setParent(Node node, Node parent) {
+    auto index = position(node);
+    auto parentIndex = parent == Node::null() ? NONE : position(parent);
+    for (auto ancestor{parentIndex}; ancestor != NONE;
+         ancestor = m_parents[ancestor]) {
+        if (ancestor == index) {
+            throw std::logic_error{
+                "Node cannot be parented to its own subtree"};
+        }
+    }
+    m_parents[index] = parentIndex;
+    m_unsorted = true;
+    markDirty(index);
+}
+
+bool TransformHierarchy::contains(Node node) const {
+    return m_positions.contains(node);
+}
+
+TransformHierarchy::Node TransformHierarchy::parent(Node node) const {
+    auto parentIndex = m_parents[position(node)];
+    return parentIndex == NONE ? Node::null() : m_nodes[parentIndex];
+}
+
+void TransformHierarchy::setLocal(Node node, const Transform& local) {
+    auto index = position(node);
+    m_translations[index] = local.translation;
+    m_rotations[index] = local.rotation;
+    m_scales[index] = local.scale;
+    markDirty(index);
+}
+
+void TransformHierarchy::setTranslation(Node node,
+                                        const glm::vec3& translation) {
+    auto index = position(node);
+    m_translations[index] = translation;
+    markDirty(index);
+}
+
+void TransformHierarchy::setRotation(Node node, const glm::quat& rotation) {
+    auto index = position(node);
+    m_rotations[index] = rotation;
+    markDirty(index);
+}
+
+void TransformHierarchy::setScale(Node node, const glm::vec3& scale) {
+    auto index = position(node);
+    m_scales[index] = scale;
+    markDirty(index);
+}
+
+Transform TransformHierarchy::local(Node node) const {
+    auto index = position(node);
+    return Transform{m_translations[index], m_rotations[index],
+                     m_scales[index]};
+}
+
+const glm::mat4& TransformHierarchy::world(Node node) const {
+    return m_world[position(node)];
+}
+
+void TransformHierarchy::update() {
+    if (m_unsorted) {
+        sort();
+    }
+    if (!m_anyDirty) {
+        return;
+    }
+    for (size_t i{0}; i < m_nodes.size(); i++) {
+        updateNode(i);
+    }
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+}
+
+void TransformHierarchy::update(ThreadPool& pool, size_t grainSize) {
+    if (m_unsorted) {
+        sort();
+    }
+    if (!m_anyDirty) {
+        return;
+    }
+    std::vector<uint32_t> spine{};
+    std::vector<Range> ranges{};
+    for (uint32_t root{0}; root < m_nodes.size();
+         root += m_subtreeSizes[root]) {
+        split(root, grainSize, spine, ranges);
+    }
+    for (auto index : spine) {
+        updateNode(index);
+    }
+
+    std::vector<Range> batches{};
+    for (size_t first{0}; first < ranges.size();) {
+        size_t count{0};
+        auto last = first;
+        while (last < ranges.size() && count < grainSize) {
+            count += ranges[last].end - ranges[last].begin;
+            last++;
+        }
+        batches.push_back(
+            Range{static_cast<uint32_t>(first), static_cast<uint32_t>(last)});
+        first = last;
+    }
+    pool.parallelFor(batches.size(), 1, [&](size_t begin, size_t end) {
+        for (auto batch{begin}; batch < end; batch++) {
+            for (auto r{batches[batch].begin}; r < batches[batch].end; r++) {
+                for (auto i{ranges[r].begin}; i < ranges[r].end; i++) {
+                    updateNode(i);
+                }
+            }
+        }
+    });
+
+    std::fill(m_dirty.begin(), m_dirty.end(), 0);
+    m_anyDirty = false;
+}
+
+uint32_t TransformHierarchy::position(Node node) const {
+    return m_positions.get(node);
+}
+
+void TransformHierarchy::markDirty(uint32_t index) {
+    m_dirty[index] = 1;
+    m_anyDirty = true;
+}
+
+void TransformHierarchy::growAncestors(uint32_t index) {
+    for (; index != NONE; index = m_parents[index]) {
+        m_subtreeSizes[index]++;
+    }
+}
+
+void TransformHierarchy::sort() {
+    auto count = static_cast<uint32_t>(m_nodes.size());
+    std::vector<uint32_t> firstChild(count + 1, 0);
+    for (uint32_t i{0}; i < count; i++) {
+        if (m_nodes[i] != Node::null() && m_parents[i] != NONE) {
+            firstChild[m_parents[i] + 1]++;
+        }
+    }
+    for (uint32_t i{0}; i < count; i++) {
+        firstChild[i + 1] += firstChild[i];
+    }
+    std::vector<uint32_t> children(firstChild[count]);
+    auto cursor = firstChild;
+    for (uint32_t i{0}; i < count; i++) {
+        if (m_nodes[i] != Node::null() && m_parents[i] != NONE) {
+            children[cursor[m_parents[i]]++] = i;
+        }
+    }
+
+    std::vector<uint32_t> order{};
+    order.reserve(m_positions.size());
+    std::vector<uint32_t> stack{};
+    for (uint32_t root{0}; root < count; root++) {
+        if (m_nodes[root] == Node::null() || m_parents[root] != NONE) {
+            continue;
+        }
+        stack.push_back(root);
+        while (!stack.empty()) {
+            auto index = stack.back();
+            stack.pop_back();
+            order.push_back(index);
+            for (auto child{firstChild[index + 1]};
+                 child > firstChild[index]; child--) {
+                stack.push_back(children[child - 1]);
+            }
+        }
+    }
+    reorder(order);
+
+    std::fill(m_subtreeSizes.begin(), m_subtreeSizes.end(), 1);
+    for (auto i{m_nodes.size()}; i-- > 0;) {
+        if (m_parents[i] != NONE) {
+            m_subtreeSizes[m_parents[i]] += m_subtreeSizes[i];
+        }
+    }
+    m_unsorted = false;
+}
+
+void TransformHierarchy::reorder(const std::vector<uint32_t>& order) {
+    std::vector<uint32_t> remap(m_nodes.size(), NONE);
+    for (uint32_t i{0}; i < order.size(); i++) {
+        remap[order[i]] = i;
+    }
+
+    gather(m_nodes, order);
+    gather(m_parents, order);
+    gather(m_subtreeSizes, order);
+    gather(m_translations, order);
+    gather(m_rotations, order);
+    gather(m_scales, order);
+    gather(m_world, order);
+    gather(m_dirty, order);
+
+    for (uint32_t i{0}; i < m_nodes.size(); i++) {
+        if (m_parents[i] != NONE) {
+            m_parents[i] = remap[m_parents[i]];
+        }
+        m_positions.get_mut(m_nodes[i]) = i;
+    }
+}
+
+void TransformHierarchy::updateNode(size_t index) {
+    auto parentIndex = m_parents[index];
+    if (parentIndex != NONE && m_dirty[parentIndex]) {
+        m_dirty[index] = 1;
+    }
+    if (!m_dirty[index]) {
+        return;
+    }
+    auto local = Transform{m_translations[index], m_rotations[index],
+                           m_scales[index]}
+                     .matrix();
+    m_world[index] =
+        parentIndex == NONE ? local : m_world[parentIndex] * local;
+}
+
+void TransformHierarchy::split(uint32_t index, size_t grainSize,
+                               std::vector<uint32_t>& spine,
+                               std::vector<Range>& ranges) const {
+    auto end = index + m_subtreeSizes[index];
+    if (m_subtreeSizes[index] <= grainSize) {
+        ranges.push_back(Range{index, end});
+        return;
+    }
+    spine.push_back(index);
+    for (auto child{index + 1}; child < end; child += m_subtreeSizes[child]) {
+        split(child, grainSize, spine, ranges);
+    }
+}
@@ -17,9 +17,17 @@ Context::Context(Window& window)
       m_brdfMap{m_quadRenderer.createBRDFMap(512, 512)} {
     createDefaultMaterial();
     createCommandBuffers();
-    m_pipeline.execute();
+    m_pipeline.setProfiler(&m_profiler, &m_gpuTimer);
+    m_pipeline.execute(threadPool());
 };
 
+ThreadPool& Context::threadPool() {
+    if (!m_threadPool) {
+        m_threadPool = std::make_unique<ThreadPool>();
+    }
+    return *m_threadPool;
+}
+
 gl::handle::Shader Context::loadShader(const std::filesystem::path& shaderDir) {
     auto& shaders = resourceStorage<Shader>();
     shaders.emplace_back(shaderDir);
@@ -58,7 +66,7 @@ void Context::createDefaultMaterial() {
 void Context::createCommandBuffers() {
     m_commands.insert<CommandBufferMap<RigidVertex, glm::mat4>>();
     m_commands.insert<CommandBufferMap<RigidVertex, glm::vec3>>();
-    m_commands.insert<CommandBufferMap<SkinVertex, glm::mat4>>();
+    m_commands.insert<CommandBufferMap<SkinVertex, SkinInstance>>();
     m_commands.insert<CommandBufferMap<glm::vec3, DebugInstance>>();
     m_commands.insert<CommandBufferMap<DebugVertex, DebugInstance>>();
 }
@@ -124,6 +132,8 @@ handle::Lighting Context::createLightPack(
 }
 
 void Context::beginFrame() {
+    m_profiler.beginFrame();
+    m_gpuTimer.beginFrame();
     window.clear();
 
     m_frameState.currentCameraMatrix = window.getCameraMatrix();
@@ -136,14 +146,18 @@ void Context::beginFrame() {
 };
 
 void Context::endFrame() {
-    flushCommandBuffers();
+    {
+        Profiler::Scope cpuScope{&m_profiler, "Context::flushCommandBuffers"};
+        GpuTimer::Scope gpuScope{&m_gpuTimer, "Context::flushCommandBuffers"};
+        flushCommandBuffers();
+    }
     window.display();
 }
 
 void Context::flushCommandBuffers() {
     processCommands<RigidVertex, glm::mat4>();
     processCommands<RigidVertex, glm::vec3>();
-    processCommands<SkinVertex, glm::mat4>();
+    processCommands<SkinVertex, SkinInstance>();
     processCommands<glm::vec3, DebugInstance>();
     processCommands<DebugVertex, DebugInstance>();
     m_commands.forEach([](auto& commands) { commands.clear(); });
@@ -203,8 +217,13 @@ void Context::setEnvironment(handle::Environment handle) {
     auto& environment =
         resourceStorage<Environment>()[m_frameState.environment.index];
 
-    m_cubeRenderer.drawSkybox(environment, m_frameState.currentCameraMatrix,
-                              m_frameState.currentCameraPosition);
+    {
+        Profiler::Scope cpuScope{&m_profiler, "CubeRenderer::drawSkybox"};
+        GpuTimer::Scope gpuScope{&m_gpuTimer, "CubeRenderer::drawSkybox"};
+        m_cubeRenderer.drawSkybox(environment,
+                                  m_frameState.currentCameraMatrix,
+                                  m_frameState.currentCameraPosition);
+    }
 
     if (m_frameState.shader != handle::Shader::null()) {
         auto& shader = useShader(m_frameState.shader);
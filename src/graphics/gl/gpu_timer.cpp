@@ -0,0 +1,63 @@
+#include "rupture/graphics/gl/gpu_timer.h"
+
+namespace gl {
+
+GpuTimer::~GpuTimer() {
+    for (auto& frame : m_frames) {
+        for (auto& query : frame.queries) {
+            glDeleteQueries(1, &query.query);
+        }
+    }
+}
+
+void GpuTimer::beginFrame() {
+    m_current = (m_current + 1) % FRAME_LATENCY;
+    auto& frame = m_frames[m_current];
+    for (size_t i{0}; i < frame.used; i++) {
+        auto& query = frame.queries[i];
+        GLint available{GL_FALSE};
+        glGetQueryObjectiv(query.query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (available == GL_FALSE) {
+            m_dropped++;
+            continue;
+        }
+        GLuint64 elapsed{0};
+        glGetQueryObjectui64v(query.query, GL_QUERY_RESULT, &elapsed);
+        m_profiler.record(Profiler::Sample{
+            query.name, Profiler::Timeline::Gpu, 0, query.frame, query.begin,
+            static_cast<int64_t>(elapsed)});
+    }
+    frame.used = 0;
+}
+
+void GpuTimer::begin(const char* name) {
+    if (!m_scopes.empty()) {
+        glEndQuery(GL_TIME_ELAPSED);
+    }
+    m_scopes.push_back(name);
+    startQuery(name);
+}
+
+void GpuTimer::end() {
+    glEndQuery(GL_TIME_ELAPSED);
+    m_scopes.pop_back();
+    if (!m_scopes.empty()) {
+        startQuery(m_scopes.back());
+    }
+}
+
+void GpuTimer::startQuery(const char* name) {
+    auto& frame = m_frames[m_current];
+    if (frame.used == frame.queries.size()) {
+        GLuint query{GL_NONE};
+        glCreateQueries(GL_TIME_ELAPSED, 1, &query);
+        frame.queries.push_back(Query{query, nullptr, 0, 0});
+    }
+    auto& query = frame.queries[frame.used++];
+    query.name = name;
+    query.frame = m_profiler.frame();
+    query.begin = m_profiler.now();
+    glBeginQuery(GL_TIME_ELAPSED, query.query);
+}
+
+}  // namespace gl
@@ -0,0 +1,390 @@
+#include "rupture/graphics/gl/render_graph.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace gl {
+
+namespace {
+
+constexpr GLbitfield INCOHERENT_BARRIERS =
+    GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT |
+    GL_FRAMEBUFFER_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT;
+
+}  // namespace
+
+RenderGraph::Builder& RenderGraph::Builder::read(Resource resource,
+                                                 Access access) {
+    m_graph.addUse(m_pass, resource, access, false);
+    return *this;
+}
+
+RenderGraph::Builder& RenderGraph::Builder::write(Resource resource,
+                                                  Access access) {
+    m_graph.addUse(m_pass, resource, access, true);
+    return *this;
+}
+
+RenderGraph::Builder& RenderGraph::Builder::sideEffect() {
+    m_graph.m_passes[m_pass].sideEffect = true;
+    return *this;
+}
+
+GLuint RenderGraph::PassResources::object(Resource resource) const {
+    return m_graph.resolve(m_pass, resource).object;
+}
+
+GLuint64 RenderGraph::PassResources::handle(Resource resource) const {
+    return m_graph.resolve(m_pass, resource).handle;
+}
+
+RenderGraph::Resource RenderGraph::createTexture(std::string name,
+                                                 const TextureDesc& desc) {
+    m_resources.push_back(ResourceNode{std::move(name), Kind::Texture, desc});
+    m_compiled = false;
+    return Resource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderGraph::Resource RenderGraph::importTexture(std::string name,
+                                                 Texture& texture) {
+    ResourceNode node{std::move(name), Kind::Texture,
+                      TextureDesc{texture.format()}, texture.texture(),
+                      texture.handle(), true};
+    m_resources.push_back(std::move(node));
+    m_compiled = false;
+    return Resource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+RenderGraph::Resource RenderGraph::importBuffer(std::string name,
+                                                GLuint buffer) {
+    ResourceNode node{std::move(name), Kind::Buffer, TextureDesc{}, buffer, 0,
+                      true};
+    m_resources.push_back(std::move(node));
+    m_compiled = false;
+    return Resource{static_cast<uint32_t>(m_resources.size() - 1)};
+}
+
+void RenderGraph::markOutput(Resource resource) {
+    m_resources.at(resource.m_index).output = true;
+    m_compiled = false;
+}
+
+void RenderGraph::compile() {
+    cull();
+    computeLifetimes();
+    alias();
+    computeBarriers();
+    m_compiled = true;
+}
+
+void RenderGraph::execute() {
+    if (!m_compiled) {
+        compile();
+    }
+    allocate();
+    for (uint32_t i{0}; i < m_passes.size(); i++) {
+        auto& pass = m_passes[i];
+        if (pass.culled) {
+            continue;
+        }
+        if (pass.barriers != 0) {
+            glMemoryBarrier(pass.barriers);
+        }
+        auto target = framebuffer(pass);
+        if (target != nullptr) {
+            target->bind(Framebuffer::BindPoint::Draw);
+        } else {
+            Framebuffer::bindDefault(Framebuffer::BindPoint::Draw);
+        }
+        PassResources resources{*this, i, target};
+        pass.execute(resources);
+    }
+    Framebuffer::bindDefault(Framebuffer::BindPoint::Draw);
+}
+
+void RenderGraph::clear() {
+    m_passes.clear();
+    m_resources.clear();
+    m_bindings.clear();
+    m_physicalDescs.clear();
+    m_compiled = false;
+}
+
+GLbitfield RenderGraph::barrierBit(Access access) {
+    switch (access) {
+        case Access::Sampled:
+            return GL_TEXTURE_FETCH_BARRIER_BIT;
+        case Access::Image:
+            return GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+        case Access::Attachment:
+            return GL_FRAMEBUFFER_BARRIER_BIT;
+        case Access::Storage:
+            return GL_SHADER_STORAGE_BARRIER_BIT;
+        default:
+            return 0;
+    }
+}
+
+bool RenderGraph::isIncoherent(Access access) {
+    return access == Access::Image || access == Access::Storage;
+}
+
+Framebuffer::Attachment RenderGraph::attachmentPoint(GLenum format,
+                                                     size_t& colorCount) {
+    switch (format) {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+            return Framebuffer::Attachment::Depth;
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return Framebuffer::Attachment::DepthStencil;
+        case GL_STENCIL_INDEX8:
+            return Framebuffer::Attachment::Stencil;
+        default:
+            if (colorCount >= 8) {
+                throw std::logic_error{"Pass has too many color attachments"};
+            }
+            return static_cast<Framebuffer::Attachment>(GL_COLOR_ATTACHMENT0 +
+                                                        colorCount++);
+    }
+}
+
+void RenderGraph::useBinding(Builder& builder, std::type_index type,
+                             bool write) {
+    auto binding = m_bindings.find(type);
+    if (binding == m_bindings.end()) {
+        return;
+    }
+    Resource resource{binding->second.resource};
+    if (write) {
+        builder.write(resource, binding->second.write);
+    } else {
+        builder.read(resource, binding->second.read);
+    }
+}
+
+void RenderGraph::addUse(uint32_t pass, Resource resource, Access access,
+                         bool write) {
+    if (resource.m_index >= m_resources.size()) {
+        throw std::out_of_range{"Unknown render graph resource"};
+    }
+    if (m_resources[resource.m_index].kind == Kind::Buffer &&
+        access != Access::Storage) {
+        throw std::logic_error{"Buffers only support storage access"};
+    }
+    m_passes[pass].uses.push_back(Use{resource.m_index, access, write});
+}
+
+void RenderGraph::cull() {
+    std::vector<uint8_t> live(m_resources.size(), 0);
+    for (size_t i{0}; i < m_resources.size(); i++) {
+        live[i] = m_resources[i].output || m_resources[i].imported;
+    }
+    for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); pass++) {
+        pass->culled = !pass->sideEffect &&
+                       std::none_of(pass->uses.begin(), pass->uses.end(),
+                                    [&live](const Use& use) {
+                                        return use.write && live[use.resource];
+                                    });
+        if (pass->culled) {
+            continue;
+        }
+        for (const auto& use : pass->uses) {
+            if (use.write && !m_resources[use.resource].imported) {
+                live[use.resource] = 0;
+            }
+        }
+        for (const auto& use : pass->uses) {
+            if (!use.write) {
+                live[use.resource] = 1;
+            }
+        }
+    }
+}
+
+void RenderGraph::computeLifetimes() {
+    for (auto& resource : m_resources) {
+        resource.lifetime = Lifetime{NONE, NONE};
+    }
+    auto last = static_cast<uint32_t>(m_passes.size());
+    for (uint32_t i{0}; i < m_passes.size(); i++) {
+        if (m_passes[i].culled) {
+            continue;
+        }
+        for (const auto& use : m_passes[i].uses) {
+            auto& lifetime = m_resources[use.resource].lifetime;
+            if (lifetime.first == NONE) {
+                lifetime.first = i;
+            }
+            lifetime.last = i;
+        }
+    }
+    for (auto& resource : m_resources) {
+        if (resource.output && resource.lifetime.first != NONE) {
+            resource.lifetime.last = last;
+        }
+    }
+}
+
+void RenderGraph::alias() {
+    std::vector<uint32_t> order{};
+    for (uint32_t i{0}; i < m_resources.size(); i++) {
+        m_resources[i].physical = NONE;
+        if (!m_resources[i].imported &&
+            m_resources[i].lifetime.first != NONE) {
+            order.push_back(i);
+        }
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [this](uint32_t lhs, uint32_t rhs) {
+                         return m_resources[lhs].lifetime.first <
+                                m_resources[rhs].lifetime.first;
+                     });
+
+    m_physicalDescs.clear();
+    std::vector<uint32_t> freeAfter{};
+    for (auto index : order) {
+        auto& resource = m_resources[index];
+        uint32_t slot{0};
+        while (slot < m_physicalDescs.size() &&
+               (m_physicalDescs[slot] != resource.desc ||
+                freeAfter[slot] >= resource.lifetime.first)) {
+            slot++;
+        }
+        if (slot == m_physicalDescs.size()) {
+            m_physicalDescs.push_back(resource.desc);
+            freeAfter.push_back(0);
+        }
+        freeAfter[slot] = resource.lifetime.last;
+        resource.physical = slot;
+    }
+}
+
+void RenderGraph::computeBarriers() {
+    auto physicalCount = static_cast<uint32_t>(m_physicalDescs.size());
+    std::vector<GLbitfield> pending(physicalCount + m_resources.size(), 0);
+    auto memory = [this, physicalCount](uint32_t resource) {
+        auto& node = m_resources[resource];
+        return node.imported ? physicalCount + resource : node.physical;
+    };
+
+    for (auto& pass : m_passes) {
+        pass.barriers = 0;
+        if (pass.culled) {
+            continue;
+        }
+        for (const auto& use : pass.uses) {
+            pass.barriers |= pending[memory(use.resource)] &
+                             barrierBit(use.access);
+        }
+        for (auto& bits : pending) {
+            bits &= ~pass.barriers;
+        }
+        for (const auto& use : pass.uses) {
+            if (use.write && isIncoherent(use.access)) {
+                pending[memory(use.resource)] = INCOHERENT_BARRIERS;
+            }
+        }
+    }
+}
+
+void RenderGraph::allocate() {
+    auto replaced = false;
+    for (size_t i{0}; i < m_physicalDescs.size(); i++) {
+        const auto& desc = m_physicalDescs[i];
+        if (i < m_textures.size() && m_textureDescs[i] == desc) {
+            continue;
+        }
+        Texture::SamplerConfig sampler{
+            desc.mipLevels > 1 ? GLenum{GL_LINEAR_MIPMAP_LINEAR}
+                               : GLenum{GL_LINEAR},
+            GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE};
+        auto texture =
+            std::make_unique<Texture>(GL_TEXTURE_2D, desc.format, desc.width,
+                                      desc.height, sampler, desc.mipLevels);
+        if (i < m_textures.size()) {
+            m_textures[i] = std::move(texture);
+            m_textureDescs[i] = desc;
+            replaced = true;
+        } else {
+            m_textures.push_back(std::move(texture));
+            m_textureDescs.push_back(desc);
+        }
+    }
+    if (replaced) {
+        m_framebuffers.clear();
+    }
+
+    for (auto& resource : m_resources) {
+        if (!resource.imported && resource.physical != NONE) {
+            auto& texture = *m_textures[resource.physical];
+            resource.object = texture.texture();
+            resource.handle = texture.handle();
+        }
+    }
+}
+
+Framebuffer* RenderGraph::framebuffer(const PassNode& pass) {
+    std::vector<uint32_t> attachments{};
+    for (const auto& use : pass.uses) {
+        if (use.access == Access::Attachment &&
+            std::find(attachments.begin(), attachments.end(), use.resource) ==
+                attachments.end()) {
+            attachments.push_back(use.resource);
+        }
+    }
+    if (attachments.empty()) {
+        return nullptr;
+    }
+    std::vector<GLuint> objects{};
+    for (auto resource : attachments) {
+        objects.push_back(m_resources[resource].object);
+    }
+
+    auto cached = std::find_if(
+        m_framebuffers.begin(), m_framebuffers.end(),
+        [&objects](const CachedFramebuffer& framebuffer) {
+            return framebuffer.attachments == objects;
+        });
+    if (cached != m_framebuffers.end()) {
+        return &cached->framebuffer;
+    }
+
+    Framebuffer target{};
+    std::vector<Framebuffer::Buffer> drawBuffers{};
+    size_t colorCount{0};
+    for (auto resource : attachments) {
+        auto& node = m_resources[resource];
+        auto point = attachmentPoint(node.desc.format, colorCount);
+        target.setAttachment(point, node.object);
+        if (colorCount > drawBuffers.size()) {
+            drawBuffers.push_back(static_cast<Framebuffer::Buffer>(point));
+        }
+    }
+    if (drawBuffers.empty()) {
+        drawBuffers.push_back(Framebuffer::Buffer::None);
+    }
+    target.setDrawBuffers(drawBuffers);
+    m_framebuffers.push_back(
+        CachedFramebuffer{std::move(objects), std::move(target)});
+    return &m_framebuffers.back().framebuffer;
+}
+
+const RenderGraph::ResourceNode& RenderGraph::resolve(
+    uint32_t pass, Resource resource) const {
+    const auto& uses = m_passes[pass].uses;
+    auto declared = std::any_of(uses.begin(), uses.end(),
+                                [&resource](const Use& use) {
+                                    return use.resource == resource.m_index;
+                                });
+    if (!declared) {
+        throw std::logic_error{"Resource not declared by pass " +
+                               m_passes[pass].name};
+    }
+    return m_resources[resource.m_index];
+}
+
+}  // namespace gl
@@ -1,5 +1,6 @@
 #include "rupture/graphics/gl/texture.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace gl {
@@ -24,9 +25,19 @@ Texture::Texture(const gltf::Texture& source, size_t mipLevels) {
     glCreateTextures(GL_TEXTURE_2D, 1, &m_glTexture);
     glTextureStorage2D(m_glTexture, mipLevels, sized_format, source.width(),
                        source.height());
-    glTextureSubImage2D(m_glTexture, 0, 0, 0, source.width(), source.height(),
-                        format, GL_UNSIGNED_BYTE, source.data().data());
-    glGenerateTextureMipmap(m_glTexture);
+    auto levels = std::min(mipLevels, source.mipLevels());
+    GLint alignment{};
+    glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level{0}; level < levels; level++) {
+        glTextureSubImage2D(m_glTexture, level, 0, 0, source.mipWidth(level),
+                            source.mipHeight(level), format, GL_UNSIGNED_BYTE,
+                            source.mipData(level));
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    if (levels < mipLevels) {
+        glGenerateTextureMipmap(m_glTexture);
+    }
 
     SamplerConfig sampler{};
 
@@ -9,7 +9,8 @@
 namespace gltf {
 
 Animation::Animation(
-    const fx::gltf::Document& document, const fx::gltf::Animation& animation,
+    const fx::gltf::Document& document, const BufferTable& buffers,
+    const fx::gltf::Animation& animation,
     const std::unordered_map<uint32_t, uint32_t>& skinNodeOrdering) {
     m_targets.resize(skinNodeOrdering.size());
     for (size_t i{0}; i < animation.channels.size(); i++) {
@@ -27,7 +28,7 @@ Animation::Animation(
             }
             throw std::runtime_error("Animation target unsupported");
         }();
-        auto view = loadSamplerData(document, sampler, property);
+        auto view = loadSamplerData(document, buffers, sampler, property);
         auto& target = m_targets[skinNodeOrdering.at(channel.target.node)];
         target.nodeId = channel.target.node;
         switch (property) {
@@ -43,25 +44,26 @@ Animation::Animation(
         }
     }
 
-    auto getBufferViewEndTime = [&](const std::optional<BufferView>& view) {
+    auto getBufferViewEndTime = [&](const std::optional<BufferView>& view,
+                                    const std::vector<float>& timeBuffer) {
         double endTime{0.0f};
-        if (view.has_value()) {
-            endTime = m_translationBuffer
-                          .timeBuffer[(*view).timeOffset + (*view).samples - 1];
+        if (view.has_value() && (*view).samples > 0) {
+            endTime = timeBuffer[(*view).timeOffset + (*view).samples - 1];
         }
         return endTime;
     };
 
     for (const auto& target : m_targets) {
-        auto endTime = std::max({getBufferViewEndTime(target.t),
-                                 getBufferViewEndTime(target.r),
-                                 getBufferViewEndTime(target.s)});
+        auto endTime = std::max(
+            {getBufferViewEndTime(target.t, m_translationBuffer.timeBuffer),
+             getBufferViewEndTime(target.r, m_rotationBuffer.timeBuffer),
+             getBufferViewEndTime(target.s, m_scaleBuffer.timeBuffer)});
         m_duration = std::max(m_duration, endTime);
     }
 }
 
 Animation::BufferView Animation::loadSamplerData(
-    const fx::gltf::Document& document,
+    const fx::gltf::Document& document, const BufferTable& buffers,
     const fx::gltf::Animation::Sampler& sampler, Property property) {
     const auto& input = document.accessors[sampler.input];
     const auto& output = document.accessors[sampler.output];
@@ -79,14 +81,18 @@ Animation::BufferView Animation::loadSamplerData(
                 throw std::runtime_error("Invalid interpolation value"s);
         };
     }();
-    auto inputData = gltf::readContiguous<float>(document, input);
+    auto inputData = gltf::readContiguous<float>(document, buffers, input);
     view.samples = inputData.size();
     switch (property) {
         case Property::Translation: {
             view.timeOffset = m_translationBuffer.timeBuffer.size();
             std::copy(inputData.begin(), inputData.end(),
                       std::back_inserter(m_translationBuffer.timeBuffer));
-            auto outputData = gltf::readContiguous<glm::vec3>(document, output);
+            auto outputData =
+                gltf::readContiguous<glm::vec3>(document, buffers, output);
+            if (view.mode == Interpolation::CubicSpline) {
+                outputData = hermiteCoefficients(inputData, outputData);
+            }
             view.targetOffset = m_translationBuffer.targetBuffer.size();
             std::copy(outputData.begin(), outputData.end(),
                       std::back_inserter(m_translationBuffer.targetBuffer));
@@ -96,7 +102,11 @@ Animation::BufferView Animation::loadSamplerData(
             view.timeOffset = m_rotationBuffer.timeBuffer.size();
             std::copy(inputData.begin(), inputData.end(),
                       std::back_inserter(m_rotationBuffer.timeBuffer));
-            auto outputData = gltf::readContiguous<glm::quat>(document, output);
+            auto outputData =
+                gltf::readContiguous<glm::quat>(document, buffers, output);
+            if (view.mode == Interpolation::CubicSpline) {
+                outputData = hermiteCoefficients(inputData, outputData);
+            }
             view.targetOffset = m_rotationBuffer.targetBuffer.size();
             std::copy(outputData.begin(), outputData.end(),
                       std::back_inserter(m_rotationBuffer.targetBuffer));
@@ -106,7 +116,11 @@ Animation::BufferView Animation::loadSamplerData(
             view.timeOffset = m_scaleBuffer.timeBuffer.size();
             std::copy(inputData.begin(), inputData.end(),
                       std::back_inserter(m_scaleBuffer.timeBuffer));
-            auto outputData = gltf::readContiguous<glm::vec3>(document, output);
+            auto outputData =
+                gltf::readContiguous<glm::vec3>(document, buffers, output);
+            if (view.mode == Interpolation::CubicSpline) {
+                outputData = hermiteCoefficients(inputData, outputData);
+            }
             view.targetOffset = m_scaleBuffer.targetBuffer.size();
             std::copy(outputData.begin(), outputData.end(),
                       std::back_inserter(m_scaleBuffer.targetBuffer));
@@ -116,4 +130,31 @@ Animation::BufferView Animation::loadSamplerData(
     return view;
 }
 
+template <typename Comp>
+std::vector<Comp> Animation::hermiteCoefficients(
+    const std::vector<float>& times, const std::vector<Comp>& keys) {
+    if (keys.size() != times.size() * 3) {
+        throw std::runtime_error("Invalid cubic spline sampler output"s);
+    }
+    std::vector<Comp> coefficients(times.size() * HERMITE_COEFFICIENTS,
+                                   Comp{});
+    for (size_t i{0}; i < times.size(); i++) {
+        auto* c = &coefficients[i * HERMITE_COEFFICIENTS];
+        const auto& value = keys[i * 3 + 1];
+        c[0] = value;
+        if (i + 1 == times.size()) {
+            break;
+        }
+        auto dt = times[i + 1] - times[i];
+        auto outTangent = keys[i * 3 + 2] * dt;
+        auto inTangent = keys[(i + 1) * 3] * dt;
+        const auto& next = keys[(i + 1) * 3 + 1];
+        c[1] = outTangent;
+        c[2] = next * 3.0f + value * -3.0f + outTangent * -2.0f +
+               inTangent * -1.0f;
+        c[3] = value * 2.0f + next * -2.0f + outTangent + inTangent;
+    }
+    return coefficients;
+}
+
 }  // namespace gltf
@@ -0,0 +1,260 @@
+#include "rupture/graphics/gltf/animation_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gltf {
+
+AnimationController::AnimationController(const Skin& skin) : m_skin{&skin} {
+    addLayer(BlendMode::Override);
+}
+
+size_t AnimationController::addLayer(BlendMode mode, std::vector<float> mask,
+                                     float weight) {
+    if (!mask.empty() && mask.size() != m_skin->jointCount()) {
+        throw std::out_of_range("Bone mask does not fit the skin");
+    }
+    m_layers.push_back(Layer{mode, std::move(mask), weight, std::nullopt,
+                             std::nullopt, std::nullopt, 0.0f, 0.0f});
+    return m_layers.size() - 1;
+}
+
+void AnimationController::play(size_t animation, float fadeDuration,
+                               bool loop, size_t layer) {
+    auto& target = m_layers.at(layer);
+    const auto& sampler = m_skin->sampler(animation);
+
+    Playback playback{animation, 0.0f, 1.0f, loop, {}, {}};
+    if (target.mode == BlendMode::Additive) {
+        playback.reference.resize(m_skin->jointCount(), 1);
+        AnimationSampler::Cursor cursor{};
+        sampler.sample(0.0f, cursor, playback.reference);
+    }
+
+    if (target.current && fadeDuration > 0.0f) {
+        if (target.previous || target.snapshot) {
+            PoseBuffer current{m_skin->jointCount(), 1};
+            PoseBuffer snapshot{m_skin->jointCount(), 1};
+            sample(*target.current, target.mode, current.view(0));
+            sampleFadeSource(target, current.view(0), snapshot.view(0));
+            target.previous.reset();
+            target.snapshot = std::move(snapshot);
+        } else {
+            target.previous = std::move(target.current);
+        }
+        target.fade = 0.0f;
+        target.fadeDuration = fadeDuration;
+    } else {
+        target.previous.reset();
+        target.snapshot.reset();
+    }
+    target.current = std::move(playback);
+}
+
+void AnimationController::stop(size_t layer) {
+    auto& target = m_layers.at(layer);
+    target.current.reset();
+    target.previous.reset();
+    target.snapshot.reset();
+}
+
+void AnimationController::setSpeed(size_t layer, float speed) {
+    auto& target = m_layers.at(layer);
+    if (!target.current) {
+        throw std::logic_error("Layer has no animation playing");
+    }
+    target.current->speed = speed;
+}
+
+void AnimationController::setLayerWeight(size_t layer, float weight) {
+    m_layers.at(layer).weight = std::clamp(weight, 0.0f, 1.0f);
+}
+
+void AnimationController::update(float deltaTime) {
+    for (auto& layer : m_layers) {
+        if (layer.current) {
+            advance(*layer.current, deltaTime);
+        }
+        if (layer.previous) {
+            advance(*layer.previous, deltaTime);
+        }
+        if (layer.previous || layer.snapshot) {
+            layer.fade += deltaTime;
+            if (layer.fade >= layer.fadeDuration) {
+                layer.previous.reset();
+                layer.snapshot.reset();
+            }
+        }
+    }
+}
+
+void AnimationController::evaluate(LinearArena& arena,
+                                   const glm::mat4& rootTransform,
+                                   Skin::Workspace& workspace,
+                                   glm::mat4* output) {
+    auto jointCount = m_skin->jointCount();
+    auto pose = PoseView::allocate(arena, jointCount);
+    auto current = PoseView::allocate(arena, jointCount);
+    auto previous = PoseView::allocate(arena, jointCount);
+    m_skin->restPose(pose);
+
+    for (auto& layer : m_layers) {
+        if (!layer.current || layer.weight <= 0.0f) {
+            continue;
+        }
+        sample(*layer.current, layer.mode, current);
+        auto fading = layer.previous || layer.snapshot;
+        if (fading) {
+            sampleFadeSource(layer, current, previous);
+        }
+        const auto& layerPose = fading ? previous : current;
+        if (layer.mode == BlendMode::Additive) {
+            add(pose, layerPose, layer.weight, layer.mask);
+        } else {
+            blend(pose, layerPose, layer.weight, layer.mask);
+        }
+    }
+
+    m_skin->poseMatrices(rootTransform, pose, workspace, output);
+}
+
+void AnimationController::advance(Playback& playback, float deltaTime) const {
+    auto duration = static_cast<float>(
+        m_skin->sampler(playback.animation).duration());
+    playback.time += deltaTime * playback.speed;
+    if (duration <= 0.0f) {
+        playback.time = 0.0f;
+    } else if (playback.loop) {
+        playback.time = std::fmod(playback.time, duration);
+        if (playback.time < 0.0f) {
+            playback.time += duration;
+        }
+    } else {
+        playback.time = std::clamp(playback.time, 0.0f, duration);
+    }
+}
+
+void AnimationController::sampleFadeSource(Layer& layer,
+                                           const PoseView& current,
+                                           const PoseView& pose) const {
+    if (layer.previous) {
+        sample(*layer.previous, layer.mode, pose);
+    } else {
+        pose.copy(layer.snapshot->view(0));
+    }
+    blend(pose, current, layer.fade / layer.fadeDuration, {});
+}
+
+void AnimationController::sample(Playback& playback, BlendMode mode,
+                                 const PoseView& pose) const {
+    m_skin->sampler(playback.animation)
+        .sample(playback.time, playback.cursor, pose);
+    if (mode != BlendMode::Additive) {
+        return;
+    }
+
+    auto reference = playback.reference.view(0);
+    for (size_t c{PoseBuffer::TranslationX}; c <= PoseBuffer::TranslationZ;
+         c++) {
+        const auto* base = reference.component(c);
+        auto* value = pose.component(c);
+        for (size_t i{0}; i < pose.jointCount(); i++) {
+            value[i] -= base[i];
+        }
+    }
+    for (size_t c{PoseBuffer::ScaleX}; c <= PoseBuffer::ScaleZ; c++) {
+        const auto* base = reference.component(c);
+        auto* value = pose.component(c);
+        for (size_t i{0}; i < pose.jointCount(); i++) {
+            value[i] = base[i] != 0.0f ? value[i] / base[i] : 1.0f;
+        }
+    }
+    auto* x = pose.component(PoseBuffer::RotationX);
+    auto* y = pose.component(PoseBuffer::RotationY);
+    auto* z = pose.component(PoseBuffer::RotationZ);
+    auto* w = pose.component(PoseBuffer::RotationW);
+    for (size_t i{0}; i < pose.jointCount(); i++) {
+        auto delta = glm::inverse(reference.rotation(i)) *
+                     glm::quat{x[i], y[i], z[i], w[i]};
+        x[i] = delta.x;
+        y[i] = delta.y;
+        z[i] = delta.z;
+        w[i] = delta.w;
+    }
+}
+
+void AnimationController::blend(const PoseView& target, const PoseView& source,
+                                float weight, const std::vector<float>& mask) {
+    auto jointCount = target.jointCount();
+    for (auto c : {PoseBuffer::TranslationX, PoseBuffer::TranslationY,
+                   PoseBuffer::TranslationZ, PoseBuffer::ScaleX,
+                   PoseBuffer::ScaleY, PoseBuffer::ScaleZ}) {
+        const auto* from = source.component(c);
+        auto* to = target.component(c);
+        for (size_t i{0}; i < jointCount; i++) {
+            auto alpha = mask.empty() ? weight : weight * mask[i];
+            to[i] += (from[i] - to[i]) * alpha;
+        }
+    }
+
+    auto* x = target.component(PoseBuffer::RotationX);
+    auto* y = target.component(PoseBuffer::RotationY);
+    auto* z = target.component(PoseBuffer::RotationZ);
+    auto* w = target.component(PoseBuffer::RotationW);
+    const auto* sx = source.component(PoseBuffer::RotationX);
+    const auto* sy = source.component(PoseBuffer::RotationY);
+    const auto* sz = source.component(PoseBuffer::RotationZ);
+    const auto* sw = source.component(PoseBuffer::RotationW);
+    for (size_t i{0}; i < jointCount; i++) {
+        auto alpha = mask.empty() ? weight : weight * mask[i];
+        if (alpha <= 0.0f) {
+            continue;
+        }
+        auto dot = x[i] * sx[i] + y[i] * sy[i] + z[i] * sz[i] + w[i] * sw[i];
+        auto beta = dot < 0.0f ? -alpha : alpha;
+        auto qx = x[i] + (sx[i] * beta - x[i] * alpha);
+        auto qy = y[i] + (sy[i] * beta - y[i] * alpha);
+        auto qz = z[i] + (sz[i] * beta - z[i] * alpha);
+        auto qw = w[i] + (sw[i] * beta - w[i] * alpha);
+        auto scale = 1.0f / std::sqrt(qx * qx + qy * qy + qz * qz + qw * qw);
+        x[i] = qx * scale;
+        y[i] = qy * scale;
+        z[i] = qz * scale;
+        w[i] = qw * scale;
+    }
+}
+
+void AnimationController::add(const PoseView& target, const PoseView& delta,
+                              float weight, const std::vector<float>& mask) {
+    auto jointCount = target.jointCount();
+    for (size_t i{0}; i < jointCount; i++) {
+        auto alpha = mask.empty() ? weight : weight * mask[i];
+        if (alpha <= 0.0f) {
+            continue;
+        }
+        for (size_t c{PoseBuffer::TranslationX};
+             c <= PoseBuffer::TranslationZ; c++) {
+            target.component(c)[i] += delta.component(c)[i] * alpha;
+        }
+        for (size_t c{PoseBuffer::ScaleX}; c <= PoseBuffer::ScaleZ; c++) {
+            target.component(c)[i] *=
+                1.0f + (delta.component(c)[i] - 1.0f) * alpha;
+        }
+
+        auto rotation = delta.rotation(i);
+        if (rotation.w < 0.0f) {
+            rotation = -rotation;
+        }
+        rotation = glm::normalize(
+            glm::quat{rotation.x * alpha, rotation.y * alpha,
+                      rotation.z * alpha, 1.0f + (rotation.w - 1.0f) * alpha});
+        auto result = target.rotation(i) * rotation;
+        target.component(PoseBuffer::RotationX)[i] = result.x;
+        target.component(PoseBuffer::RotationY)[i] = result.y;
+        target.component(PoseBuffer::RotationZ)[i] = result.z;
+        target.component(PoseBuffer::RotationW)[i] = result.w;
+    }
+}
+
+}  // namespace gltf
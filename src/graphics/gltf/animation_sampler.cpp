@@ -0,0 +1,749 @@
+#include "rupture/graphics/gltf/animation_sampler.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gltf {
+
+namespace {
+
+const size_t SIMD_WIDTH = 4;
+const size_t BLOCK_SIZE = 64;
+const uint32_t LINEAR_SEARCH_LIMIT = 4;
+
+size_t alignToWidth(size_t count) {
+    return (count + SIMD_WIDTH - 1) / SIMD_WIDTH * SIMD_WIDTH;
+}
+
+// Linear interpolation of `count` vectors in place, count must be a multiple
+// of SIMD_WIDTH.
+void lerp(float* x, float* y, float* z, const float* nx, const float* ny,
+          const float* nz, const float* alpha, size_t count) {
+#if defined(__SSE2__)
+    for (size_t i{0}; i < count; i += SIMD_WIDTH) {
+        auto t = _mm_load_ps(alpha + i);
+        auto px = _mm_load_ps(x + i);
+        auto py = _mm_load_ps(y + i);
+        auto pz = _mm_load_ps(z + i);
+        px = _mm_add_ps(px, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(nx + i), px), t));
+        py = _mm_add_ps(py, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(ny + i), py), t));
+        pz = _mm_add_ps(pz, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(nz + i), pz), t));
+        _mm_store_ps(x + i, px);
+        _mm_store_ps(y + i, py);
+        _mm_store_ps(z + i, pz);
+    }
+#else
+    for (size_t i{0}; i < count; i++) {
+        x[i] += (nx[i] - x[i]) * alpha[i];
+        y[i] += (ny[i] - y[i]) * alpha[i];
+        z[i] += (nz[i] - z[i]) * alpha[i];
+    }
+#endif
+}
+
+// Normalized lerp with a polynomial correction of the interpolation factor
+// that approximates slerp to within ~1e-4 (see "Approximating slerp",
+// Kapoulkine), taking the shortest path.
+void slerp(float* x, float* y, float* z, float* w, const float* nx,
+           const float* ny, const float* nz, const float* nw,
+           const float* alpha, size_t count) {
+#if defined(__SSE2__)
+    const auto signMask = _mm_set1_ps(-0.0f);
+    const auto one = _mm_set1_ps(1.0f);
+    const auto half = _mm_set1_ps(0.5f);
+    for (size_t i{0}; i < count; i += SIMD_WIDTH) {
+        auto t = _mm_load_ps(alpha + i);
+        auto px = _mm_load_ps(x + i);
+        auto py = _mm_load_ps(y + i);
+        auto pz = _mm_load_ps(z + i);
+        auto pw = _mm_load_ps(w + i);
+        auto qx = _mm_load_ps(nx + i);
+        auto qy = _mm_load_ps(ny + i);
+        auto qz = _mm_load_ps(nz + i);
+        auto qw = _mm_load_ps(nw + i);
+
+        auto cosine = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(px, qx), _mm_mul_ps(py, qy)),
+            _mm_add_ps(_mm_mul_ps(pz, qz), _mm_mul_ps(pw, qw)));
+        auto sign = _mm_and_ps(cosine, signMask);
+        auto d = _mm_andnot_ps(signMask, cosine);
+
+        auto a = _mm_add_ps(
+            _mm_set1_ps(1.0904f),
+            _mm_mul_ps(
+                d, _mm_add_ps(
+                       _mm_set1_ps(-3.2452f),
+                       _mm_mul_ps(d, _mm_sub_ps(
+                                         _mm_set1_ps(3.55645f),
+                                         _mm_mul_ps(d, _mm_set1_ps(
+                                                           1.43519f)))))));
+        auto b = _mm_add_ps(
+            _mm_set1_ps(0.848013f),
+            _mm_mul_ps(d, _mm_add_ps(_mm_set1_ps(-1.06021f),
+                                     _mm_mul_ps(d, _mm_set1_ps(0.215638f)))));
+        auto centered = _mm_sub_ps(t, half);
+        auto k = _mm_add_ps(_mm_mul_ps(a, _mm_mul_ps(centered, centered)), b);
+        auto ot = _mm_add_ps(
+            t, _mm_mul_ps(_mm_mul_ps(t, centered),
+                          _mm_mul_ps(_mm_sub_ps(t, one), k)));
+
+        auto lt = _mm_sub_ps(one, ot);
+        auto rt = _mm_xor_ps(ot, sign);
+        px = _mm_add_ps(_mm_mul_ps(px, lt), _mm_mul_ps(qx, rt));
+        py = _mm_add_ps(_mm_mul_ps(py, lt), _mm_mul_ps(qy, rt));
+        pz = _mm_add_ps(_mm_mul_ps(pz, lt), _mm_mul_ps(qz, rt));
+        pw = _mm_add_ps(_mm_mul_ps(pw, lt), _mm_mul_ps(qw, rt));
+
+        auto length = _mm_sqrt_ps(
+            _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)),
+                       _mm_add_ps(_mm_mul_ps(pz, pz), _mm_mul_ps(pw, pw))));
+        auto scale = _mm_div_ps(one, length);
+        _mm_store_ps(x + i, _mm_mul_ps(px, scale));
+        _mm_store_ps(y + i, _mm_mul_ps(py, scale));
+        _mm_store_ps(z + i, _mm_mul_ps(pz, scale));
+        _mm_store_ps(w + i, _mm_mul_ps(pw, scale));
+    }
+#else
+    for (size_t i{0}; i < count; i++) {
+        auto t = alpha[i];
+        auto cosine = x[i] * nx[i] + y[i] * ny[i] + z[i] * nz[i] + w[i] * nw[i];
+        auto d = std::abs(cosine);
+        auto a = 1.0904f + d * (-3.2452f + d * (3.55645f - d * 1.43519f));
+        auto b = 0.848013f + d * (-1.06021f + d * 0.215638f);
+        auto k = a * (t - 0.5f) * (t - 0.5f) + b;
+        auto ot = t + t * (t - 0.5f) * (t - 1.0f) * k;
+        auto lt = 1.0f - ot;
+        auto rt = cosine < 0.0f ? -ot : ot;
+        auto rx = x[i] * lt + nx[i] * rt;
+        auto ry = y[i] * lt + ny[i] * rt;
+        auto rz = z[i] * lt + nz[i] * rt;
+        auto rw = w[i] * lt + nw[i] * rt;
+        auto scale = 1.0f / std::sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+        x[i] = rx * scale;
+        y[i] = ry * scale;
+        z[i] = rz * scale;
+        w[i] = rw * scale;
+    }
+#endif
+}
+
+// Evaluates c0 + c1 t + c2 t^2 + c3 t^3 in place into c0, count must be a
+// multiple of SIMD_WIDTH.
+void hermite(float* c0, const float* c1, const float* c2, const float* c3,
+             const float* alpha, size_t count) {
+#if defined(__SSE2__)
+    for (size_t i{0}; i < count; i += SIMD_WIDTH) {
+        auto t = _mm_load_ps(alpha + i);
+        auto value = _mm_add_ps(_mm_mul_ps(_mm_load_ps(c3 + i), t),
+                                _mm_load_ps(c2 + i));
+        value = _mm_add_ps(_mm_mul_ps(value, t), _mm_load_ps(c1 + i));
+        value = _mm_add_ps(_mm_mul_ps(value, t), _mm_load_ps(c0 + i));
+        _mm_store_ps(c0 + i, value);
+    }
+#else
+    for (size_t i{0}; i < count; i++) {
+        auto t = alpha[i];
+        c0[i] = ((c3[i] * t + c2[i]) * t + c1[i]) * t + c0[i];
+    }
+#endif
+}
+
+void normalize(float* x, float* y, float* z, float* w, size_t count) {
+    for (size_t i{0}; i < count; i++) {
+        auto scale =
+            1.0f / std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i] +
+                             w[i] * w[i]);
+        x[i] *= scale;
+        y[i] *= scale;
+        z[i] *= scale;
+        w[i] *= scale;
+    }
+}
+
+}  // namespace
+
+PoseBuffer::PoseBuffer(size_t jointCount, size_t instanceCount) {
+    resize(jointCount, instanceCount);
+}
+
+void PoseBuffer::resize(size_t jointCount, size_t instanceCount) {
+    m_jointCount = jointCount;
+    m_instanceCount = instanceCount;
+    m_stride = alignToWidth(jointCount);
+    m_data.assign(ComponentCount * m_instanceCount * m_stride, 0.0f);
+}
+
+glm::vec3 PoseBuffer::translation(size_t instance, size_t joint) const {
+    return {component(instance, TranslationX)[joint],
+            component(instance, TranslationY)[joint],
+            component(instance, TranslationZ)[joint]};
+}
+
+glm::quat PoseBuffer::rotation(size_t instance, size_t joint) const {
+    return {component(instance, RotationX)[joint],
+            component(instance, RotationY)[joint],
+            component(instance, RotationZ)[joint],
+            component(instance, RotationW)[joint]};
+}
+
+glm::vec3 PoseBuffer::scale(size_t instance, size_t joint) const {
+    return {component(instance, ScaleX)[joint],
+            component(instance, ScaleY)[joint],
+            component(instance, ScaleZ)[joint]};
+}
+
+void PoseBuffer::setTranslation(size_t instance, size_t joint,
+                                const glm::vec3& value) {
+    component(instance, TranslationX)[joint] = value.x;
+    component(instance, TranslationY)[joint] = value.y;
+    component(instance, TranslationZ)[joint] = value.z;
+}
+
+void PoseBuffer::setRotation(size_t instance, size_t joint,
+                             const glm::quat& value) {
+    component(instance, RotationX)[joint] = value.x;
+    component(instance, RotationY)[joint] = value.y;
+    component(instance, RotationZ)[joint] = value.z;
+    component(instance, RotationW)[joint] = value.w;
+}
+
+void PoseBuffer::setScale(size_t instance, size_t joint,
+                          const glm::vec3& value) {
+    component(instance, ScaleX)[joint] = value.x;
+    component(instance, ScaleY)[joint] = value.y;
+    component(instance, ScaleZ)[joint] = value.z;
+}
+
+PoseView PoseView::allocate(LinearArena& arena, size_t jointCount) {
+    auto stride = alignToWidth(jointCount);
+    auto* data = static_cast<float*>(
+        arena.allocate(PoseBuffer::ComponentCount * stride * sizeof(float),
+                       SIMD_WIDTH * sizeof(float)));
+    return PoseView{data, jointCount, stride};
+}
+
+glm::vec3 PoseView::translation(size_t joint) const {
+    return {component(PoseBuffer::TranslationX)[joint],
+            component(PoseBuffer::TranslationY)[joint],
+            component(PoseBuffer::TranslationZ)[joint]};
+}
+
+glm::quat PoseView::rotation(size_t joint) const {
+    return {component(PoseBuffer::RotationX)[joint],
+            component(PoseBuffer::RotationY)[joint],
+            component(PoseBuffer::RotationZ)[joint],
+            component(PoseBuffer::RotationW)[joint]};
+}
+
+glm::vec3 PoseView::scale(size_t joint) const {
+    return {component(PoseBuffer::ScaleX)[joint],
+            component(PoseBuffer::ScaleY)[joint],
+            component(PoseBuffer::ScaleZ)[joint]};
+}
+
+void PoseView::copy(const PoseView& other) const {
+    if (other.m_jointCount != m_jointCount) {
+        throw std::out_of_range("Pose joint counts do not match");
+    }
+    for (size_t c{0}; c < PoseBuffer::ComponentCount; c++) {
+        std::copy(other.component(c), other.component(c) + m_jointCount,
+                  component(c));
+    }
+}
+
+AnimationSampler::AnimationSampler(const Animation& animation)
+    : m_animation{&animation},
+      m_jointCount{animation.m_targets.size()},
+      m_duration{animation.duration()} {
+    auto addChannel = [](std::vector<Channel>& channels,
+                         std::vector<Channel>& cubicChannels,
+                         std::vector<uint32_t>& statics, uint32_t joint,
+                         const std::optional<Animation::BufferView>& view) {
+        if (!view.has_value() || (*view).samples == 0) {
+            statics.push_back(joint);
+            return;
+        }
+        auto& target = (*view).mode == Interpolation::CubicSpline
+                           ? cubicChannels
+                           : channels;
+        target.push_back(Channel{joint, (*view).timeOffset,
+                                 (*view).targetOffset, (*view).samples,
+                                 (*view).mode});
+    };
+
+    for (uint32_t joint{0}; joint < m_jointCount; joint++) {
+        const auto& target = animation.m_targets[joint];
+        addChannel(m_translations, m_cubicTranslations, m_staticTranslations,
+                   joint, target.t);
+        addChannel(m_rotations, m_cubicRotations, m_staticRotations, joint,
+                   target.r);
+        addChannel(m_scales, m_cubicScales, m_staticScales, joint, target.s);
+    }
+}
+
+AnimationSampler::AnimationSampler(
+    std::shared_ptr<const CompressedAnimation> animation)
+    : m_animation{nullptr},
+      m_compressed{std::move(animation)},
+      m_jointCount{m_compressed->jointCount()},
+      m_duration{m_compressed->duration()} {
+    auto addStatics = [&](CompressedAnimation::Group group,
+                          std::vector<uint32_t>& statics) {
+        std::vector<bool> animated(m_jointCount, false);
+        const auto* tracks = m_compressed->tracks(group);
+        for (size_t i{0}; i < m_compressed->trackCount(group); i++) {
+            animated[tracks[i].joint] = true;
+        }
+        for (uint32_t joint{0}; joint < m_jointCount; joint++) {
+            if (!animated[joint]) {
+                statics.push_back(joint);
+            }
+        }
+    };
+    addStatics(CompressedAnimation::Translations, m_staticTranslations);
+    addStatics(CompressedAnimation::Rotations, m_staticRotations);
+    addStatics(CompressedAnimation::Scales, m_staticScales);
+
+    for (size_t group{0}; group < CompressedAnimation::GroupCount; group++) {
+        m_tracks[group].resize(m_compressed->trackCount(
+            static_cast<CompressedAnimation::Group>(group)));
+        std::iota(m_tracks[group].begin(), m_tracks[group].end(), 0u);
+    }
+}
+
+void AnimationSampler::sample(float time, Cursor& cursor, PoseBuffer& pose,
+                              size_t instance) const {
+    sample(&time, &cursor, 1, pose, instance);
+}
+
+void AnimationSampler::sample(const float* times, Cursor* cursors,
+                              size_t count, PoseBuffer& pose,
+                              size_t firstInstance) const {
+    if (firstInstance + count > pose.instanceCount()) {
+        throw std::out_of_range("Pose buffer does not fit the animation");
+    }
+    for (size_t i{0}; i < count; i++) {
+        sample(times[i], cursors[i], pose.view(firstInstance + i));
+    }
+}
+
+void AnimationSampler::sample(float time, Cursor& cursor,
+                              const PoseView& pose) const {
+    if (pose.jointCount() != m_jointCount) {
+        throw std::out_of_range("Pose buffer does not fit the animation");
+    }
+
+    auto channelCount =
+        m_compressed
+            ? m_tracks[CompressedAnimation::Translations].size() +
+                  m_tracks[CompressedAnimation::Rotations].size() +
+                  m_tracks[CompressedAnimation::Scales].size()
+            : m_translations.size() + m_rotations.size() + m_scales.size() +
+                  m_cubicTranslations.size() + m_cubicRotations.size() +
+                  m_cubicScales.size();
+    auto& keys = cursor.m_keys;
+    if (keys.size() != channelCount) {
+        keys.assign(channelCount, 0);
+    }
+
+    auto* tx = pose.component(PoseBuffer::TranslationX);
+    auto* ty = pose.component(PoseBuffer::TranslationY);
+    auto* tz = pose.component(PoseBuffer::TranslationZ);
+    auto* rx = pose.component(PoseBuffer::RotationX);
+    auto* ry = pose.component(PoseBuffer::RotationY);
+    auto* rz = pose.component(PoseBuffer::RotationZ);
+    auto* rw = pose.component(PoseBuffer::RotationW);
+    auto* sx = pose.component(PoseBuffer::ScaleX);
+    auto* sy = pose.component(PoseBuffer::ScaleY);
+    auto* sz = pose.component(PoseBuffer::ScaleZ);
+
+    for (auto joint : m_staticTranslations) {
+        tx[joint] = ty[joint] = tz[joint] = 0.0f;
+    }
+    for (auto joint : m_staticRotations) {
+        rx[joint] = ry[joint] = rz[joint] = 0.0f;
+        rw[joint] = 1.0f;
+    }
+    for (auto joint : m_staticScales) {
+        sx[joint] = sy[joint] = sz[joint] = 1.0f;
+    }
+
+    auto* keyCursor = keys.data();
+    if (m_compressed) {
+        sampleCompressedVectors(CompressedAnimation::Translations, time,
+                                keyCursor, tx, ty, tz);
+        keyCursor += m_tracks[CompressedAnimation::Translations].size();
+        sampleCompressedRotations(time, keyCursor, rx, ry, rz, rw);
+        keyCursor += m_tracks[CompressedAnimation::Rotations].size();
+        sampleCompressedVectors(CompressedAnimation::Scales, time, keyCursor,
+                                sx, sy, sz);
+        return;
+    }
+
+    sampleVectors(m_translations, m_animation->m_translationBuffer, time,
+                  keyCursor, tx, ty, tz);
+    keyCursor += m_translations.size();
+    sampleRotations(time, keyCursor, rx, ry, rz, rw);
+    keyCursor += m_rotations.size();
+    sampleVectors(m_scales, m_animation->m_scaleBuffer, time, keyCursor, sx,
+                  sy, sz);
+    keyCursor += m_scales.size();
+
+    float* translations[]{tx, ty, tz};
+    float* rotations[]{rx, ry, rz, rw};
+    float* scales[]{sx, sy, sz};
+    sampleCubic(m_cubicTranslations, m_animation->m_translationBuffer, time,
+                keyCursor, translations);
+    keyCursor += m_cubicTranslations.size();
+    sampleCubic(m_cubicRotations, m_animation->m_rotationBuffer, time,
+                keyCursor, rotations);
+    keyCursor += m_cubicRotations.size();
+    sampleCubic(m_cubicScales, m_animation->m_scaleBuffer, time, keyCursor,
+                scales);
+}
+
+AnimationSampler AnimationSampler::withFrozenJoints(
+    const std::vector<bool>& frozen) const {
+    if (frozen.size() != m_jointCount) {
+        throw std::out_of_range("Joint mask does not fit the animation");
+    }
+    auto result{*this};
+    auto eraseFrozen = [&](auto& items, auto joint) {
+        items.erase(std::remove_if(items.begin(), items.end(),
+                                   [&](const auto& item) {
+                                       return frozen[joint(item)];
+                                   }),
+                    items.end());
+    };
+    auto channelJoint = [](const Channel& channel) { return channel.joint; };
+    auto staticJoint = [](uint32_t joint) { return joint; };
+    for (auto* channels :
+         {&result.m_translations, &result.m_rotations, &result.m_scales,
+          &result.m_cubicTranslations, &result.m_cubicRotations,
+          &result.m_cubicScales}) {
+        eraseFrozen(*channels, channelJoint);
+    }
+    for (auto* statics : {&result.m_staticTranslations,
+                          &result.m_staticRotations, &result.m_staticScales}) {
+        eraseFrozen(*statics, staticJoint);
+    }
+    if (m_compressed) {
+        for (size_t group{0}; group < CompressedAnimation::GroupCount;
+             group++) {
+            const auto* tracks = m_compressed->tracks(
+                static_cast<CompressedAnimation::Group>(group));
+            eraseFrozen(result.m_tracks[group],
+                        [&](uint32_t track) { return tracks[track].joint; });
+        }
+    }
+    return result;
+}
+
+AnimationSampler::Segment AnimationSampler::findSegment(const float* first,
+                                                       uint32_t samples,
+                                                       Interpolation mode,
+                                                       float time,
+                                                       uint32_t& cursor) {
+    const auto* last = first + samples;
+    auto key = cursor;
+    if (key >= samples || first[key] > time) {
+        key = static_cast<uint32_t>(std::upper_bound(first, last, time) -
+                                    first);
+        key = key > 0 ? key - 1 : 0;
+    } else {
+        uint32_t steps{0};
+        while (key + 1 < samples && first[key + 1] <= time) {
+            if (++steps > LINEAR_SEARCH_LIMIT) {
+                key = static_cast<uint32_t>(
+                    std::upper_bound(first + key, last, time) - first - 1);
+                break;
+            }
+            key++;
+        }
+    }
+    cursor = key;
+
+    if (key + 1 == samples || time <= first[key] ||
+        mode == Interpolation::Step) {
+        return {key, key, 0.0f};
+    }
+    return {key, key + 1,
+            (time - first[key]) / (first[key + 1] - first[key])};
+}
+
+void AnimationSampler::sampleVectors(
+    const std::vector<Channel>& channels,
+    const Animation::AnimationBuffer<glm::vec3>& buffer, float time,
+    uint32_t* cursors, float* x, float* y, float* z) const {
+    alignas(16) float px[BLOCK_SIZE];
+    alignas(16) float py[BLOCK_SIZE];
+    alignas(16) float pz[BLOCK_SIZE];
+    alignas(16) float nx[BLOCK_SIZE];
+    alignas(16) float ny[BLOCK_SIZE];
+    alignas(16) float nz[BLOCK_SIZE];
+    alignas(16) float alpha[BLOCK_SIZE];
+
+    for (size_t begin{0}; begin < channels.size(); begin += BLOCK_SIZE) {
+        auto count = std::min(BLOCK_SIZE, channels.size() - begin);
+        for (size_t i{0}; i < count; i++) {
+            const auto& channel = channels[begin + i];
+            auto segment = findSegment(
+                buffer.timeBuffer.data() + channel.timeOffset,
+                channel.samples, channel.mode, time, cursors[begin + i]);
+            const auto& prev =
+                buffer.targetBuffer[channel.keyOffset + segment.prev];
+            const auto& next =
+                buffer.targetBuffer[channel.keyOffset + segment.next];
+            px[i] = prev.x;
+            py[i] = prev.y;
+            pz[i] = prev.z;
+            nx[i] = next.x;
+            ny[i] = next.y;
+            nz[i] = next.z;
+            alpha[i] = segment.alpha;
+        }
+        auto padded = alignToWidth(count);
+        for (auto i = count; i < padded; i++) {
+            px[i] = py[i] = pz[i] = nx[i] = ny[i] = nz[i] = alpha[i] = 0.0f;
+        }
+
+        lerp(px, py, pz, nx, ny, nz, alpha, padded);
+
+        for (size_t i{0}; i < count; i++) {
+            auto joint = channels[begin + i].joint;
+            x[joint] = px[i];
+            y[joint] = py[i];
+            z[joint] = pz[i];
+        }
+    }
+}
+
+void AnimationSampler::sampleRotations(float time, uint32_t* cursors,
+                                       float* x, float* y, float* z,
+                                       float* w) const {
+    const auto& buffer = m_animation->m_rotationBuffer;
+    alignas(16) float px[BLOCK_SIZE];
+    alignas(16) float py[BLOCK_SIZE];
+    alignas(16) float pz[BLOCK_SIZE];
+    alignas(16) float pw[BLOCK_SIZE];
+    alignas(16) float nx[BLOCK_SIZE];
+    alignas(16) float ny[BLOCK_SIZE];
+    alignas(16) float nz[BLOCK_SIZE];
+    alignas(16) float nw[BLOCK_SIZE];
+    alignas(16) float alpha[BLOCK_SIZE];
+
+    for (size_t begin{0}; begin < m_rotations.size(); begin += BLOCK_SIZE) {
+        auto count = std::min(BLOCK_SIZE, m_rotations.size() - begin);
+        for (size_t i{0}; i < count; i++) {
+            const auto& channel = m_rotations[begin + i];
+            auto segment = findSegment(
+                buffer.timeBuffer.data() + channel.timeOffset,
+                channel.samples, channel.mode, time, cursors[begin + i]);
+            const auto& prev =
+                buffer.targetBuffer[channel.keyOffset + segment.prev];
+            const auto& next =
+                buffer.targetBuffer[channel.keyOffset + segment.next];
+            px[i] = prev.x;
+            py[i] = prev.y;
+            pz[i] = prev.z;
+            pw[i] = prev.w;
+            nx[i] = next.x;
+            ny[i] = next.y;
+            nz[i] = next.z;
+            nw[i] = next.w;
+            alpha[i] = segment.alpha;
+        }
+        auto padded = alignToWidth(count);
+        for (auto i = count; i < padded; i++) {
+            px[i] = py[i] = pz[i] = nx[i] = ny[i] = nz[i] = alpha[i] = 0.0f;
+            pw[i] = nw[i] = 1.0f;
+        }
+
+        slerp(px, py, pz, pw, nx, ny, nz, nw, alpha, padded);
+
+        for (size_t i{0}; i < count; i++) {
+            auto joint = m_rotations[begin + i].joint;
+            x[joint] = px[i];
+            y[joint] = py[i];
+            z[joint] = pz[i];
+            w[joint] = pw[i];
+        }
+    }
+}
+
+template <typename Comp>
+void AnimationSampler::sampleCubic(
+    const std::vector<Channel>& channels,
+    const Animation::AnimationBuffer<Comp>& buffer, float time,
+    uint32_t* cursors, float* const* outputs) const {
+    const size_t components = sizeof(Comp) / sizeof(float);
+    const auto coefficientCount = Animation::HERMITE_COEFFICIENTS;
+    alignas(16) float coefficients[components][coefficientCount][BLOCK_SIZE];
+    alignas(16) float alpha[BLOCK_SIZE];
+
+    for (size_t begin{0}; begin < channels.size(); begin += BLOCK_SIZE) {
+        auto count = std::min(BLOCK_SIZE, channels.size() - begin);
+        for (size_t i{0}; i < count; i++) {
+            const auto& channel = channels[begin + i];
+            auto segment = findSegment(
+                buffer.timeBuffer.data() + channel.timeOffset,
+                channel.samples, channel.mode, time, cursors[begin + i]);
+            const auto* keys =
+                &buffer.targetBuffer[channel.keyOffset +
+                                     segment.prev * coefficientCount];
+            for (size_t c{0}; c < components; c++) {
+                for (size_t k{0}; k < coefficientCount; k++) {
+                    coefficients[c][k][i] = keys[k][c];
+                }
+            }
+            alpha[i] = segment.alpha;
+        }
+        auto padded = alignToWidth(count);
+        for (auto i = count; i < padded; i++) {
+            for (size_t c{0}; c < components; c++) {
+                coefficients[c][0][i] = 1.0f;
+                for (size_t k{1}; k < coefficientCount; k++) {
+                    coefficients[c][k][i] = 0.0f;
+                }
+            }
+            alpha[i] = 0.0f;
+        }
+
+        for (size_t c{0}; c < components; c++) {
+            hermite(coefficients[c][0], coefficients[c][1],
+                    coefficients[c][2], coefficients[c][3], alpha, padded);
+        }
+        if constexpr (std::is_same<glm::quat, Comp>::value) {
+            normalize(coefficients[0][0], coefficients[1][0],
+                      coefficients[2][0], coefficients[3][0], count);
+        }
+
+        for (size_t i{0}; i < count; i++) {
+            auto joint = channels[begin + i].joint;
+            for (size_t c{0}; c < components; c++) {
+                outputs[c][joint] = coefficients[c][0][i];
+            }
+        }
+    }
+}
+
+void AnimationSampler::sampleCompressedVectors(
+    CompressedAnimation::Group group, float time, uint32_t* cursors,
+    float* x, float* y, float* z) const {
+    const auto* tracks = m_compressed->tracks(group);
+    const auto& indices = m_tracks[group];
+    const auto trackCount = indices.size();
+    const auto* times = m_compressed->times();
+    const auto* keys = m_compressed->keys();
+    const auto keyWords = CompressedAnimation::KEY_WORDS;
+    alignas(16) float px[BLOCK_SIZE];
+    alignas(16) float py[BLOCK_SIZE];
+    alignas(16) float pz[BLOCK_SIZE];
+    alignas(16) float nx[BLOCK_SIZE];
+    alignas(16) float ny[BLOCK_SIZE];
+    alignas(16) float nz[BLOCK_SIZE];
+    alignas(16) float alpha[BLOCK_SIZE];
+
+    for (size_t begin{0}; begin < trackCount; begin += BLOCK_SIZE) {
+        auto count = std::min(BLOCK_SIZE, trackCount - begin);
+        for (size_t i{0}; i < count; i++) {
+            const auto& track = tracks[indices[begin + i]];
+            auto segment =
+                findSegment(times + track.timeOffset, track.samples,
+                            track.mode, time, cursors[begin + i]);
+            auto prev = CompressedAnimation::decodeVector(
+                track, keys + (track.keyOffset + segment.prev) * keyWords);
+            auto next = CompressedAnimation::decodeVector(
+                track, keys + (track.keyOffset + segment.next) * keyWords);
+            px[i] = prev.x;
+            py[i] = prev.y;
+            pz[i] = prev.z;
+            nx[i] = next.x;
+            ny[i] = next.y;
+            nz[i] = next.z;
+            alpha[i] = segment.alpha;
+        }
+        auto padded = alignToWidth(count);
+        for (auto i = count; i < padded; i++) {
+            px[i] = py[i] = pz[i] = nx[i] = ny[i] = nz[i] = alpha[i] = 0.0f;
+        }
+
+        lerp(px, py, pz, nx, ny, nz, alpha, padded);
+
+        for (size_t i{0}; i < count; i++) {
+            auto joint = tracks[indices[begin + i]].joint;
+            x[joint] = px[i];
+            y[joint] = py[i];
+            z[joint] = pz[i];
+        }
+    }
+}
+
+void AnimationSampler::sampleCompressedRotations(float time,
+                                                 uint32_t* cursors, float* x,
+                                                 float* y, float* z,
+                                                 float* w) const {
+    const auto group = CompressedAnimation::Rotations;
+    const auto* tracks = m_compressed->tracks(group);
+    const auto& indices = m_tracks[group];
+    const auto trackCount = indices.size();
+    const auto* times = m_compressed->times();
+    const auto* keys = m_compressed->keys();
+    const auto keyWords = CompressedAnimation::KEY_WORDS;
+    alignas(16) float px[BLOCK_SIZE];
+    alignas(16) float py[BLOCK_SIZE];
+    alignas(16) float pz[BLOCK_SIZE];
+    alignas(16) float pw[BLOCK_SIZE];
+    alignas(16) float nx[BLOCK_SIZE];
+    alignas(16) float ny[BLOCK_SIZE];
+    alignas(16) float nz[BLOCK_SIZE];
+    alignas(16) float nw[BLOCK_SIZE];
+    alignas(16) float alpha[BLOCK_SIZE];
+
+    for (size_t begin{0}; begin < trackCount; begin += BLOCK_SIZE) {
+        auto count = std::min(BLOCK_SIZE, trackCount - begin);
+        for (size_t i{0}; i < count; i++) {
+            const auto& track = tracks[indices[begin + i]];
+            auto segment =
+                findSegment(times + track.timeOffset, track.samples,
+                            track.mode, time, cursors[begin + i]);
+            auto prev = CompressedAnimation::decodeRotation(
+                keys + (track.keyOffset + segment.prev) * keyWords);
+            auto next = CompressedAnimation::decodeRotation(
+                keys + (track.keyOffset + segment.next) * keyWords);
+            px[i] = prev.x;
+            py[i] = prev.y;
+            pz[i] = prev.z;
+            pw[i] = prev.w;
+            nx[i] = next.x;
+            ny[i] = next.y;
+            nz[i] = next.z;
+            nw[i] = next.w;
+            alpha[i] = segment.alpha;
+        }
+        auto padded = alignToWidth(count);
+        for (auto i = count; i < padded; i++) {
+            px[i] = py[i] = pz[i] = nx[i] = ny[i] = nz[i] = alpha[i] = 0.0f;
+            pw[i] = nw[i] = 1.0f;
+        }
+
+        slerp(px, py, pz, pw, nx, ny, nz, nw, alpha, padded);
+
+        for (size_t i{0}; i < count; i++) {
+            auto joint = tracks[indices[begin + i]].joint;
+            x[joint] = px[i];
+            y[joint] = py[i];
+            z[joint] = pz[i];
+            w[joint] = pw[i];
+        }
+    }
+}
+
+}  // namespace gltf
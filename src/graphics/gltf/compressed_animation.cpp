@@ -0,0 +1,263 @@
+#include "rupture/graphics/gltf/compressed_animation.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace gltf {
+
+namespace {
+
+const float QUANTIZED_RANGE = 65535.0f;
+const float ROTATION_RANGE = 32767.0f;
+
+size_t alignToCacheLine(size_t size) {
+    return (size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+glm::vec3 interpolate(const glm::vec3& a, const glm::vec3& b, float t) {
+    return glm::mix(a, b, t);
+}
+
+glm::quat interpolate(const glm::quat& a, glm::quat b, float t) {
+    if (glm::dot(a, b) < 0.0f) {
+        b = -b;
+    }
+    return glm::normalize(glm::mix(a, b, t));
+}
+
+float distance(const glm::vec3& a, const glm::vec3& b) {
+    auto d = glm::abs(a - b);
+    return std::max({d.x, d.y, d.z});
+}
+
+float distance(const glm::quat& a, glm::quat b) {
+    if (glm::dot(a, b) < 0.0f) {
+        b = -b;
+    }
+    return std::max({std::abs(a.x - b.x), std::abs(a.y - b.y),
+                     std::abs(a.z - b.z), std::abs(a.w - b.w)});
+}
+
+}  // namespace
+
+template <typename Comp>
+CompressedAnimation::SourceTrack<Comp> CompressedAnimation::resample(
+    const Animation::AnimationBuffer<Comp>& buffer,
+    const Animation::BufferView& view, uint32_t joint,
+    uint32_t subdivisions) {
+    SourceTrack<Comp> track{joint, view.mode, {}, {}};
+    const auto* times = buffer.timeBuffer.data() + view.timeOffset;
+    if (view.mode == Interpolation::CubicSpline) {
+        track.mode = Interpolation::Linear;
+        subdivisions = std::max(subdivisions, 1u);
+        for (uint32_t i{0}; i + 1 < view.samples; i++) {
+            for (uint32_t s{0}; s < subdivisions; s++) {
+                track.times.push_back(times[i] + (times[i + 1] - times[i]) *
+                                                     s / subdivisions);
+            }
+        }
+        track.times.push_back(times[view.samples - 1]);
+        for (auto time : track.times) {
+            track.keys.push_back(buffer.sample(view, time));
+        }
+    } else {
+        track.times.assign(times, times + view.samples);
+        track.keys.assign(buffer.targetBuffer.begin() + view.targetOffset,
+                          buffer.targetBuffer.begin() + view.targetOffset +
+                              view.samples);
+    }
+
+    if constexpr (std::is_same<glm::quat, Comp>::value) {
+        for (size_t i{1}; i < track.keys.size(); i++) {
+            if (glm::dot(track.keys[i - 1], track.keys[i]) < 0.0f) {
+                track.keys[i] = -track.keys[i];
+            }
+        }
+    }
+    return track;
+}
+
+template <typename Comp>
+void CompressedAnimation::reduce(SourceTrack<Comp>& track, float error) {
+    const auto& times = track.times;
+    const auto& keys = track.keys;
+    if (keys.size() < 2) {
+        return;
+    }
+
+    std::vector<size_t> kept{0};
+    if (track.mode == Interpolation::Step) {
+        for (size_t i{1}; i < keys.size(); i++) {
+            if (distance(keys[kept.back()], keys[i]) > error) {
+                kept.push_back(i);
+            }
+        }
+    } else {
+        auto fits = [&](size_t first, size_t last) {
+            for (auto i = first + 1; i < last; i++) {
+                auto t = (times[i] - times[first]) /
+                         (times[last] - times[first]);
+                if (distance(interpolate(keys[first], keys[last], t),
+                             keys[i]) > error) {
+                    return false;
+                }
+            }
+            return true;
+        };
+        for (size_t last{2}; last < keys.size(); last++) {
+            if (!fits(kept.back(), last)) {
+                kept.push_back(last - 1);
+            }
+        }
+        kept.push_back(keys.size() - 1);
+        if (kept.size() == 2 && distance(keys[0], keys.back()) <= error) {
+            kept.pop_back();
+        }
+    }
+
+    SourceTrack<Comp> reduced{track.joint, track.mode, {}, {}};
+    for (auto i : kept) {
+        reduced.times.push_back(times[i]);
+        reduced.keys.push_back(keys[i]);
+    }
+    track = std::move(reduced);
+}
+
+void CompressedAnimation::quantize(const SourceTrack<glm::vec3>& track,
+                                   Track& output, uint16_t* keys) {
+    auto low = track.keys.front();
+    auto high = track.keys.front();
+    for (const auto& key : track.keys) {
+        low = glm::min(low, key);
+        high = glm::max(high, key);
+    }
+    for (int c{0}; c < 3; c++) {
+        output.origin[c] = low[c];
+        output.step[c] = (high[c] - low[c]) / QUANTIZED_RANGE;
+    }
+    for (const auto& key : track.keys) {
+        for (int c{0}; c < 3; c++) {
+            auto value = output.step[c] > 0.0f
+                             ? (key[c] - low[c]) / output.step[c]
+                             : 0.0f;
+            *keys++ = static_cast<uint16_t>(
+                std::clamp(std::lround(value), 0l, 65535l));
+        }
+    }
+}
+
+void CompressedAnimation::quantize(const SourceTrack<glm::quat>& track,
+                                   Track& output, uint16_t* keys) {
+    std::fill(std::begin(output.origin), std::end(output.origin), 0.0f);
+    std::fill(std::begin(output.step), std::end(output.step), 0.0f);
+    for (const auto& key : track.keys) {
+        encodeRotation(key, keys);
+        keys += KEY_WORDS;
+    }
+}
+
+CompressedAnimation::CompressedAnimation(const Animation& animation,
+                                         const CompressionSettings& settings)
+    : m_jointCount{animation.m_targets.size()},
+      m_duration{animation.duration()} {
+    std::vector<SourceTrack<glm::vec3>> translations;
+    std::vector<SourceTrack<glm::quat>> rotations;
+    std::vector<SourceTrack<glm::vec3>> scales;
+    for (uint32_t joint{0}; joint < m_jointCount; joint++) {
+        const auto& target = animation.m_targets[joint];
+        if (target.t.has_value() && (*target.t).samples > 0) {
+            translations.push_back(resample(animation.m_translationBuffer,
+                                            *target.t, joint,
+                                            settings.cubicSubdivisions));
+            reduce(translations.back(), settings.translationError);
+        }
+        if (target.r.has_value() && (*target.r).samples > 0) {
+            rotations.push_back(resample(animation.m_rotationBuffer,
+                                         *target.r, joint,
+                                         settings.cubicSubdivisions));
+            reduce(rotations.back(), settings.rotationError);
+        }
+        if (target.s.has_value() && (*target.s).samples > 0) {
+            scales.push_back(resample(animation.m_scaleBuffer, *target.s,
+                                      joint, settings.cubicSubdivisions));
+            reduce(scales.back(), settings.scaleError);
+        }
+    }
+
+    m_groupOffsets[Translations] = 0;
+    m_groupOffsets[Rotations] = translations.size();
+    m_groupOffsets[Scales] = m_groupOffsets[Rotations] + rotations.size();
+    m_groupOffsets[GroupCount] = m_groupOffsets[Scales] + scales.size();
+    for (const auto& track : translations) {
+        m_keyCount += track.keys.size();
+    }
+    for (const auto& track : rotations) {
+        m_keyCount += track.keys.size();
+    }
+    for (const auto& track : scales) {
+        m_keyCount += track.keys.size();
+    }
+
+    m_trackOffset = 0;
+    m_timeOffset = alignToCacheLine(m_groupOffsets[GroupCount] *
+                                    sizeof(Track));
+    m_keyOffset = alignToCacheLine(m_timeOffset + m_keyCount * sizeof(float));
+    m_byteSize = alignToCacheLine(m_keyOffset + m_keyCount * KEY_WORDS *
+                                                    sizeof(uint16_t));
+    m_blob.reset(static_cast<std::byte*>(::operator new(
+        std::max(m_byteSize, CACHE_LINE_SIZE),
+        std::align_val_t{CACHE_LINE_SIZE})));
+    std::memset(m_blob.get(), 0, m_byteSize);
+
+    auto* tracks = reinterpret_cast<Track*>(m_blob.get() + m_trackOffset);
+    auto* times = reinterpret_cast<float*>(m_blob.get() + m_timeOffset);
+    auto* keys = reinterpret_cast<uint16_t*>(m_blob.get() + m_keyOffset);
+    uint32_t keyIndex{0};
+    auto write = [&](const auto& sources) {
+        for (const auto& source : sources) {
+            auto& track = *tracks++;
+            track.joint = source.joint;
+            track.timeOffset = keyIndex;
+            track.keyOffset = keyIndex;
+            track.samples = static_cast<uint32_t>(source.keys.size());
+            track.mode = source.mode;
+            std::copy(source.times.begin(), source.times.end(),
+                      times + keyIndex);
+            quantize(source, track, keys + keyIndex * KEY_WORDS);
+            keyIndex += track.samples;
+        }
+    };
+    write(translations);
+    write(rotations);
+    write(scales);
+}
+
+void CompressedAnimation::encodeRotation(glm::quat rotation, uint16_t* key) {
+    const float scale = ROTATION_RANGE / 1.41421356f;
+    const float bias = 0.70710678f;
+    rotation = glm::normalize(rotation);
+    float c[4]{rotation.x, rotation.y, rotation.z, rotation.w};
+    size_t largest{0};
+    for (size_t i{1}; i < 4; i++) {
+        if (std::abs(c[i]) > std::abs(c[largest])) {
+            largest = i;
+        }
+    }
+    auto sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+    uint64_t bits{uint64_t{largest} << 45};
+    for (size_t i{0}, shift{0}; i < 4; i++) {
+        if (i == largest) {
+            continue;
+        }
+        auto value = std::lround((c[i] * sign + bias) * scale);
+        bits |= uint64_t(std::clamp(value, 0l, 32767l)) << shift;
+        shift += 15;
+    }
+    key[0] = static_cast<uint16_t>(bits);
+    key[1] = static_cast<uint16_t>(bits >> 16);
+    key[2] = static_cast<uint16_t>(bits >> 32);
+}
+
+}  // namespace gltf
@@ -0,0 +1,568 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#include "rupture/content_hash.h"
+#include "rupture/graphics/gltf/document.h"
+#include "rupture/mapped_file.h"
+
+namespace gltf {
+
+namespace {
+
+const uint32_t COOKED_MAGIC = 0x4b435052;
+const uint32_t COOKED_VERSION = 1;
+const size_t COOKED_ALIGNMENT = 16;
+
+struct CookedHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t sourceHash;
+    uint64_t payloadSize;
+    uint64_t payloadHash;
+    uint64_t rigidVertexSize;
+    uint64_t skinVertexSize;
+};
+
+struct NodePair {
+    uint32_t key;
+    uint32_t value;
+};
+
+class CookedWriter {
+   public:
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable<T>::value);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const T* data, size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value);
+        write<uint64_t>(count);
+        m_bytes.resize((m_bytes.size() + COOKED_ALIGNMENT - 1) /
+                       COOKED_ALIGNMENT * COOKED_ALIGNMENT);
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data);
+        m_bytes.insert(m_bytes.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        writeArray(values.data(), values.size());
+    }
+
+    void writeString(const std::string& value) {
+        writeArray(value.data(), value.size());
+    }
+
+    const std::vector<uint8_t>& bytes() const { return m_bytes; }
+
+   private:
+    std::vector<uint8_t> m_bytes;
+};
+
+class CookedReader {
+   public:
+    CookedReader(const uint8_t* data, size_t size)
+        : m_data{data}, m_size{size} {}
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value);
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    template <typename T>
+    void readArray(std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable<T>::value);
+        auto count = read<uint64_t>();
+        m_offset = (m_offset + COOKED_ALIGNMENT - 1) / COOKED_ALIGNMENT *
+                   COOKED_ALIGNMENT;
+        if (count > (m_size - std::min(m_offset, m_size)) / sizeof(T)) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), take(count * sizeof(T)),
+                        count * sizeof(T));
+        }
+    }
+
+    std::string readString() {
+        std::vector<char> value{};
+        readArray(value);
+        return {value.begin(), value.end()};
+    }
+
+    bool done() const { return m_offset == m_size; }
+
+   private:
+    const uint8_t* take(size_t size) {
+        if (m_offset > m_size || size > m_size - m_offset) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        const auto* data = m_data + m_offset;
+        m_offset += size;
+        return data;
+    }
+
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset{0};
+};
+
+uint64_t fileHash(const std::filesystem::path& path) {
+    MappedFile file{path};
+    return contentHash(file.data(), file.size());
+}
+
+template <typename Vert>
+void writeMeshes(CookedWriter& writer, const std::vector<Mesh<Vert>>& meshes) {
+    writer.write<uint64_t>(meshes.size());
+    for (const auto& mesh : meshes) {
+        writer.write<uint32_t>(enum_integer(mesh.mode()));
+        writer.writeArray(mesh.vertices());
+        writer.write<uint32_t>(mesh.indices().has_value());
+        if (mesh.indices().has_value()) {
+            writer.writeArray(*mesh.indices());
+        }
+    }
+}
+
+template <typename Vert>
+void readMeshes(CookedReader& reader, std::vector<Mesh<Vert>>& meshes) {
+    auto count = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < count; i++) {
+        auto mode = reader.read<uint32_t>();
+        if (mode > enum_integer(PrimitiveMode::TriangleFan)) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        std::vector<Vert> vertices{};
+        std::vector<uint32_t> indices{};
+        reader.readArray(vertices);
+        auto indexed = reader.read<uint32_t>() != 0;
+        if (indexed) {
+            reader.readArray(indices);
+        }
+        if (vertices.empty()) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        auto& mesh = meshes.emplace_back(std::move(vertices),
+                                         std::move(indices),
+                                         static_cast<PrimitiveMode>(mode));
+        if (!indexed) {
+            mesh.indices() = std::nullopt;
+        }
+    }
+}
+
+template <typename Model>
+void writeModels(CookedWriter& writer,
+                 const std::unordered_map<std::string, Model>& models) {
+    writer.write<uint64_t>(models.size());
+    for (const auto& [name, model] : models) {
+        writer.writeString(name);
+        writer.write<int64_t>(model.skin.has_value()
+                                  ? static_cast<int64_t>(*model.skin)
+                                  : -1);
+        writer.write<uint64_t>(model.primitives.size());
+        for (const auto& primitive : model.primitives) {
+            writer.write<uint32_t>(primitive.meshIndex);
+            writer.write<int64_t>(
+                primitive.materialIndex.has_value()
+                    ? static_cast<int64_t>(*primitive.materialIndex)
+                    : -1);
+        }
+    }
+}
+
+template <typename Model>
+void readModels(CookedReader& reader,
+                std::unordered_map<std::string, Model>& models,
+                size_t meshCount, size_t skinCount) {
+    auto count = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < count; i++) {
+        auto name = reader.readString();
+        Model model{};
+        auto skin = reader.read<int64_t>();
+        if (skin >= static_cast<int64_t>(skinCount)) {
+            throw std::runtime_error("Corrupt cooked asset");
+        } else if (skin >= 0) {
+            model.skin = static_cast<uint32_t>(skin);
+        }
+        auto primitives = reader.read<uint64_t>();
+        for (uint64_t j{0}; j < primitives; j++) {
+            auto& primitive = model.primitives.emplace_back();
+            primitive.meshIndex = reader.read<uint32_t>();
+            if (primitive.meshIndex >= meshCount) {
+                throw std::runtime_error("Corrupt cooked asset");
+            }
+            auto material = reader.read<int64_t>();
+            if (material >= 0) {
+                primitive.materialIndex = static_cast<uint32_t>(material);
+            }
+        }
+        models.emplace(std::move(name), std::move(model));
+    }
+}
+
+}  // namespace
+
+std::filesystem::path Document::cookedPath(
+    const std::filesystem::path& path,
+    const std::filesystem::path& cacheDirectory) {
+    auto source = std::filesystem::absolute(path).lexically_normal().string();
+    std::ostringstream name{};
+    name << path.stem().string() << '.' << std::hex << std::setw(16)
+         << std::setfill('0') << contentHash(source.data(), source.size())
+         << ".cooked";
+    return cacheDirectory / name.str();
+}
+
+bool Document::loadCooked(const std::filesystem::path& cooked,
+                          const std::filesystem::path& path,
+                          uint64_t sourceHash) {
+    if (!std::filesystem::exists(cooked)) {
+        return false;
+    }
+
+    MappedFile file{cooked};
+    CookedHeader header{};
+    if (file.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (header.magic != COOKED_MAGIC || header.version != COOKED_VERSION ||
+        header.sourceHash != sourceHash ||
+        header.payloadSize != file.size() - sizeof(header) ||
+        header.rigidVertexSize != sizeof(RigidVertex) ||
+        header.skinVertexSize != sizeof(SkinVertex) ||
+        header.payloadHash !=
+            contentHash(file.data() + sizeof(header), header.payloadSize)) {
+        return false;
+    }
+
+    CookedReader reader{file.data() + sizeof(header), header.payloadSize};
+    auto dependencies = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < dependencies; i++) {
+        std::filesystem::path dependency{reader.readString()};
+        auto hash = reader.read<uint64_t>();
+        if (!std::filesystem::exists(dependency) ||
+            fileHash(dependency) != hash) {
+            return false;
+        }
+    }
+
+    m_name = path.stem().string();
+
+    auto& textures = at<Texture>();
+    auto textureCount = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < textureCount; i++) {
+        auto width = reader.read<uint64_t>();
+        auto height = reader.read<uint64_t>();
+        auto format = reader.read<int32_t>();
+        auto mipLevels = reader.read<uint64_t>();
+        if (format < enum_integer(Texture::Format::Grey) ||
+            format > enum_integer(Texture::Format::RGBA) || mipLevels == 0 ||
+            mipLevels > 64) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        auto& texture = textures.emplace_back(Texture::null());
+        texture.m_width = width;
+        texture.m_height = height;
+        texture.m_format = static_cast<Texture::Format>(format);
+        texture.m_mipLevels = mipLevels;
+        reader.readArray(texture.m_imageData);
+        auto last = mipLevels - 1;
+        auto components = static_cast<size_t>(format);
+        if (texture.mipOffset(last) + texture.mipWidth(last) *
+                                          texture.mipHeight(last) *
+                                          components !=
+            texture.m_imageData.size()) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+    }
+
+    auto& materials = at<pbrMaterial>();
+    auto materialCount = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < materialCount; i++) {
+        auto& material = materials.emplace_back();
+        for (auto& textureMap : material.m_textureMaps) {
+            auto index = reader.read<int64_t>();
+            if (index >= 0) {
+                textureMap = static_cast<size_t>(index);
+            }
+        }
+        material.m_baseColor = reader.read<glm::vec4>();
+        material.m_emissionStrength = reader.read<glm::vec3>();
+        material.m_roughness = reader.read<float>();
+        material.m_metalness = reader.read<float>();
+        material.m_normalScale = reader.read<float>();
+        material.m_occlusionStrength = reader.read<float>();
+    }
+
+    auto checkView = [](const Animation::BufferView& view,
+                        const auto& buffer) {
+        auto keys = uint64_t{view.samples};
+        if (view.mode == Animation::Interpolation::CubicSpline) {
+            keys *= Animation::HERMITE_COEFFICIENTS;
+        }
+        if (view.timeOffset + uint64_t{view.samples} >
+                buffer.timeBuffer.size() ||
+            view.targetOffset + keys > buffer.targetBuffer.size()) {
+            throw std::runtime_error("Corrupt cooked asset");
+        }
+        return view;
+    };
+
+    auto& skins = at<Skin>();
+    auto skinCount = reader.read<uint64_t>();
+    for (uint64_t i{0}; i < skinCount; i++) {
+        Skin skin{};
+        skin.m_rootTransform = reader.read<glm::mat4>();
+        auto jointCount = reader.read<uint64_t>();
+        for (uint64_t j{0}; j < jointCount; j++) {
+            auto& joint = skin.m_joints.emplace_back();
+            joint.inverseBind = reader.read<glm::mat4>();
+            joint.r = reader.read<glm::quat>();
+            joint.t = reader.read<glm::vec3>();
+            joint.s = reader.read<glm::vec3>();
+            joint.firstChild = reader.read<uint32_t>();
+            joint.numChildren = reader.read<uint32_t>();
+            joint.nodeId = reader.read<uint32_t>();
+            joint.name = reader.readString();
+            if (joint.firstChild + uint64_t{joint.numChildren} > jointCount) {
+                throw std::runtime_error("Corrupt cooked asset");
+            }
+        }
+        reader.readArray(skin.m_parents);
+        reader.readArray(skin.m_skinIndices);
+        reader.readArray(skin.m_inverseBinds);
+
+        std::vector<NodePair> pairs{};
+        reader.readArray(pairs);
+        for (const auto& pair : pairs) {
+            skin.m_meshNodeIndexMap.emplace(pair.key, pair.value);
+        }
+        reader.readArray(pairs);
+        for (const auto& pair : pairs) {
+            skin.m_skinIndexJointMap.emplace(pair.key, pair.value);
+        }
+
+        auto animationCount = reader.read<uint64_t>();
+        for (uint64_t j{0}; j < animationCount; j++) {
+            auto name = reader.readString();
+            Animation animation{};
+            animation.m_duration = reader.read<double>();
+            reader.readArray(animation.m_translationBuffer.timeBuffer);
+            reader.readArray(animation.m_translationBuffer.targetBuffer);
+            reader.readArray(animation.m_rotationBuffer.timeBuffer);
+            reader.readArray(animation.m_rotationBuffer.targetBuffer);
+            reader.readArray(animation.m_scaleBuffer.timeBuffer);
+            reader.readArray(animation.m_scaleBuffer.targetBuffer);
+            auto targetCount = reader.read<uint64_t>();
+            for (uint64_t k{0}; k < targetCount; k++) {
+                auto& target = animation.m_targets.emplace_back();
+                auto channels = reader.read<uint32_t>();
+                auto t = reader.read<Animation::BufferView>();
+                auto r = reader.read<Animation::BufferView>();
+                auto s = reader.read<Animation::BufferView>();
+                target.nodeId = reader.read<int32_t>();
+                if (channels & 1) {
+                    target.t = checkView(t, animation.m_translationBuffer);
+                }
+                if (channels & 2) {
+                    target.r = checkView(r, animation.m_rotationBuffer);
+                }
+                if (channels & 4) {
+                    target.s = checkView(s, animation.m_scaleBuffer);
+                }
+            }
+            skin.registerAnimation(
+                std::move(name),
+                std::make_shared<const Animation>(std::move(animation)));
+        }
+        skins.push_back(std::move(skin));
+    }
+
+    readMeshes(reader, at<Mesh<RigidVertex>>());
+    readMeshes(reader, at<Mesh<SkinVertex>>());
+    readModels(reader, getModels<RigidVertex>(), at<Mesh<RigidVertex>>().size(),
+               skins.size());
+    readModels(reader, getModels<SkinVertex>(), at<Mesh<SkinVertex>>().size(),
+               skins.size());
+    if (!reader.done()) {
+        throw std::runtime_error("Corrupt cooked asset");
+    }
+    return true;
+}
+
+void Document::writeCooked(const std::filesystem::path& cooked,
+                           const std::filesystem::path& path,
+                           const fx::gltf::Document& document,
+                           uint64_t sourceHash) const {
+    CookedWriter writer{};
+
+    auto root = fx::gltf::detail::GetDocumentRootPath(path);
+    std::vector<std::filesystem::path> dependencies{};
+    for (const auto& buffer : document.buffers) {
+        if (!buffer.uri.empty() && !buffer.IsEmbeddedResource()) {
+            dependencies.push_back(
+                std::filesystem::absolute(
+                    fx::gltf::detail::CreateBufferUriPath(root, buffer.uri))
+                    .lexically_normal());
+        }
+    }
+    for (const auto& image : document.images) {
+        if (!image.uri.empty() && !image.IsEmbeddedResource()) {
+            dependencies.push_back(
+                std::filesystem::absolute(root / image.uri).lexically_normal());
+        }
+    }
+    writer.write<uint64_t>(dependencies.size());
+    for (const auto& dependency : dependencies) {
+        writer.writeString(dependency.string());
+        writer.write<uint64_t>(fileHash(dependency));
+    }
+
+    const auto& textures = at<Texture>();
+    writer.write<uint64_t>(textures.size());
+    for (const auto& texture : textures) {
+        writer.write<uint64_t>(texture.width());
+        writer.write<uint64_t>(texture.height());
+        writer.write<int32_t>(enum_integer(texture.format()));
+        writer.write<uint64_t>(texture.mipLevels());
+        writer.writeArray(texture.data());
+    }
+
+    const auto& materials = at<pbrMaterial>();
+    writer.write<uint64_t>(materials.size());
+    for (const auto& material : materials) {
+        for (const auto& textureMap : material.m_textureMaps) {
+            writer.write<int64_t>(textureMap.has_value()
+                                      ? static_cast<int64_t>(*textureMap)
+                                      : -1);
+        }
+        writer.write(material.m_baseColor);
+        writer.write(material.m_emissionStrength);
+        writer.write(material.m_roughness);
+        writer.write(material.m_metalness);
+        writer.write(material.m_normalScale);
+        writer.write(material.m_occlusionStrength);
+    }
+
+    const auto& skins = at<Skin>();
+    writer.write<uint64_t>(skins.size());
+    for (const auto& skin : skins) {
+        writer.write(skin.m_rootTransform);
+        writer.write<uint64_t>(skin.m_joints.size());
+        for (const auto& joint : skin.m_joints) {
+            writer.write(joint.inverseBind);
+            writer.write(joint.r);
+            writer.write(joint.t);
+            writer.write(joint.s);
+            writer.write(joint.firstChild);
+            writer.write(joint.numChildren);
+            writer.write(joint.nodeId);
+            writer.writeString(joint.name);
+        }
+        writer.writeArray(skin.m_parents);
+        writer.writeArray(skin.m_skinIndices);
+        writer.writeArray(skin.m_inverseBinds);
+
+        std::vector<NodePair> pairs{};
+        for (const auto& [key, value] : skin.m_meshNodeIndexMap) {
+            pairs.push_back(NodePair{key, value});
+        }
+        writer.writeArray(pairs);
+        pairs.clear();
+        for (const auto& [key, value] : skin.m_skinIndexJointMap) {
+            pairs.push_back(NodePair{key, value});
+        }
+        writer.writeArray(pairs);
+
+        std::vector<const std::string*> names(skin.m_animations.size());
+        for (const auto& [name, index] : skin.m_animationMap) {
+            names.at(index) = &name;
+        }
+        writer.write<uint64_t>(skin.m_animations.size());
+        for (size_t i{0}; i < skin.m_animations.size(); i++) {
+            const auto* animation = skin.m_animations[i].get();
+            if (animation == nullptr || names[i] == nullptr) {
+                throw std::logic_error("Cannot cook compressed animations");
+            }
+            writer.writeString(*names[i]);
+            writer.write(animation->m_duration);
+            writer.writeArray(animation->m_translationBuffer.timeBuffer);
+            writer.writeArray(animation->m_translationBuffer.targetBuffer);
+            writer.writeArray(animation->m_rotationBuffer.timeBuffer);
+            writer.writeArray(animation->m_rotationBuffer.targetBuffer);
+            writer.writeArray(animation->m_scaleBuffer.timeBuffer);
+            writer.writeArray(animation->m_scaleBuffer.targetBuffer);
+            writer.write<uint64_t>(animation->m_targets.size());
+            for (const auto& target : animation->m_targets) {
+                writer.write<uint32_t>(target.t.has_value() |
+                                       target.r.has_value() << 1 |
+                                       target.s.has_value() << 2);
+                writer.write(target.t.value_or(Animation::BufferView{}));
+                writer.write(target.r.value_or(Animation::BufferView{}));
+                writer.write(target.s.value_or(Animation::BufferView{}));
+                writer.write(target.nodeId);
+            }
+        }
+    }
+
+    writeMeshes(writer, at<Mesh<RigidVertex>>());
+    writeMeshes(writer, at<Mesh<SkinVertex>>());
+    writeModels(writer, getModels<RigidVertex>());
+    writeModels(writer, getModels<SkinVertex>());
+
+    CookedHeader header{COOKED_MAGIC,
+                        COOKED_VERSION,
+                        sourceHash,
+                        writer.bytes().size(),
+                        contentHash(writer.bytes().data(),
+                                    writer.bytes().size()),
+                        sizeof(RigidVertex),
+                        sizeof(SkinVertex)};
+
+    std::filesystem::create_directories(cooked.parent_path());
+    auto staging = cooked;
+    staging += ".tmp";
+    {
+        std::ofstream output{staging, std::ios::binary | std::ios::trunc};
+        output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        output.write(reinterpret_cast<const char*>(writer.bytes().data()),
+                     writer.bytes().size());
+        if (!output) {
+            output.close();
+            std::error_code error{};
+            std::filesystem::remove(staging, error);
+            throw std::runtime_error("Failed to write cooked asset: " +
+                                     staging.string());
+        }
+    }
+    std::filesystem::rename(staging, cooked);
+}
+
+void Document::reset() {
+    at<Texture>().clear();
+    at<pbrMaterial>().clear();
+    at<Skin>().clear();
+    at<Mesh<RigidVertex>>().clear();
+    at<Mesh<SkinVertex>>().clear();
+    getModels<RigidVertex>().clear();
+    getModels<SkinVertex>().clear();
+}
+
+}  // namespace gltf
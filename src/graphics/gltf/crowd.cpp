@@ -0,0 +1,110 @@
+#include "rupture/graphics/gltf/crowd.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "rupture/graphics/gltf/animation_controller.h"
+
+namespace gltf {
+
+size_t CrowdAnimator::add(const Skin& skin, size_t animation, float time,
+                          const glm::mat4& rootTransform, float lodMetric) {
+    auto offset = m_paletteSize;
+    m_instances.push_back(
+        Instance{&skin, animation, time, rootTransform, lodMetric});
+    m_offsets.push_back(offset);
+    m_paletteSize += skin.jointCount();
+    return offset;
+}
+
+void CrowdAnimator::clear() {
+    m_instances.clear();
+    m_offsets.clear();
+    m_paletteSize = 0;
+}
+
+void CrowdAnimator::setLodLevels(std::vector<LodLevel> levels) {
+    for (const auto& level : levels) {
+        if (level.updateInterval == 0) {
+            throw std::logic_error("LOD update interval must be positive");
+        }
+    }
+    std::sort(levels.begin(), levels.end(),
+              [](const LodLevel& a, const LodLevel& b) {
+                  return a.maxMetric < b.maxMetric;
+              });
+    m_lodLevels = std::move(levels);
+    m_lodStates.clear();
+}
+
+void CrowdAnimator::update(ThreadPool& pool, glm::mat4* palettes,
+                           size_t capacity) {
+    if (m_paletteSize > capacity) {
+        throw std::out_of_range("Joint palette buffer too small for crowd");
+    }
+    if (m_workspaces.size() < m_instances.size()) {
+        m_workspaces.resize(m_instances.size());
+    }
+    if (m_lodStates.size() < m_instances.size()) {
+        m_lodStates.resize(m_instances.size());
+    }
+    pool.parallelFor(
+        m_instances.size(), m_jobSize, [&](size_t begin, size_t end) {
+            for (auto i = begin; i < end; i++) {
+                animate(i, palettes + m_offsets[i]);
+            }
+        });
+    m_frame++;
+}
+
+CrowdAnimator::LodLevel CrowdAnimator::lodLevel(float metric) const {
+    if (m_lodLevels.empty()) {
+        return LodLevel{metric, 1, false};
+    }
+    auto it = std::lower_bound(m_lodLevels.begin(), m_lodLevels.end(), metric,
+                               [](const LodLevel& level, float value) {
+                                   return level.maxMetric < value;
+                               });
+    return it != m_lodLevels.end() ? *it : m_lodLevels.back();
+}
+
+void CrowdAnimator::animate(size_t instance, glm::mat4* output) {
+    const auto& target = m_instances[instance];
+    const auto& skin = *target.skin;
+    auto& workspace = m_workspaces[instance];
+    auto& state = m_lodStates[instance];
+    auto level = lodLevel(target.lodMetric);
+    if (level.updateInterval <= 1) {
+        state.skin = nullptr;
+        skin.jointMatrices(target.rootTransform, target.animation, target.time,
+                           workspace, output, level.freezeLeaves);
+        return;
+    }
+
+    if (state.skin != target.skin || state.animation != target.animation) {
+        state.skin = target.skin;
+        state.animation = target.animation;
+        state.next.resize(skin.jointCount(), 1);
+        state.pose.resize(skin.jointCount(), 1);
+        skin.samplePose(target.animation, target.time, workspace,
+                        state.next.view(0));
+        state.previous = state.next;
+        state.age = 0;
+    } else if ((m_frame + instance) % level.updateInterval == 0) {
+        std::swap(state.previous, state.next);
+        skin.samplePose(target.animation, target.time, workspace,
+                        state.next.view(0), level.freezeLeaves);
+        state.age = 0;
+    }
+
+    auto alpha = std::min(
+        1.0f, static_cast<float>(state.age + 1) / level.updateInterval);
+    state.age = std::min(state.age + 1, level.updateInterval);
+    auto pose = state.pose.view(0);
+    pose.copy(state.previous.view(0));
+    AnimationController::blend(pose, state.next.view(0), alpha, {});
+    skin.poseMatrices(target.rootTransform, pose, workspace, output);
+}
+
+}  // namespace gltf
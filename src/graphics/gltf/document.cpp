@@ -1,28 +1,63 @@
 #include "rupture/graphics/gltf/document.h"
 
 #include <glm/gtc/type_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <optional>
 #include <queue>
 #include <unordered_map>
 #include <vector>
 
+#include "rupture/content_hash.h"
+#include "rupture/graphics/gltf/mapped_document.h"
 #include "rupture/graphics/gltf/utils.h"
+#include "rupture/mapped_file.h"
 
 using namespace std::string_literals;
 
 namespace gltf {
 
 Document::Document(const std::filesystem::path& path) {
-    auto document = [&]() -> fx::gltf::Document {
-        auto ext = path.extension();
-        if (ext == ".gltf"s) {
-            return fx::gltf::LoadFromText(path);
-        } else if (ext == ".glb"s) {
-            return fx::gltf::LoadFromBinary(path);
-        } else {
-            throw std::invalid_argument("Invalid extension: " + path.string());
-        }
+    ThreadPool pool{};
+    MappedDocument mapped{path};
+    loadDocument(path, mapped.document(), mapped.buffers(), pool);
+}
+
+Document::Document(const std::filesystem::path& path, ThreadPool& pool) {
+    MappedDocument mapped{path};
+    loadDocument(path, mapped.document(), mapped.buffers(), pool);
+}
+
+Document::Document(const std::filesystem::path& path,
+                   const std::filesystem::path& cacheDirectory,
+                   ThreadPool& pool) {
+    auto cooked = cookedPath(path, cacheDirectory);
+    auto sourceHash = [&]() {
+        MappedFile source{path};
+        return contentHash(source.data(), source.size());
     }();
-    loadDocument(path, document);
+    try {
+        if (loadCooked(cooked, path, sourceHash)) {
+            return;
+        }
+    } catch (const std::exception&) {
+    }
+    reset();
+
+    MappedDocument mapped{path};
+    loadDocument(path, mapped.document(), mapped.buffers(), pool);
+    auto& textures = at<Texture>();
+    pool.parallelFor(textures.size(), 1, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++) {
+            textures[i].generateMipmaps();
+        }
+    });
+    try {
+        writeCooked(cooked, path, mapped.document(), sourceHash);
+    } catch (const std::exception& e) {
+        std::cerr << "[Cache Error][" << cooked.string() << "]" << e.what()
+                  << '\n';
+    }
 }
 
 std::unordered_map<uint32_t, uint32_t> Document::getNodeParentMap(
@@ -84,22 +119,52 @@ Document::NodeTransforms Document::getNodeTransforms(
     return {globalTransform, inverseTransform};
 }
 
+struct Document::Import {
+    struct PendingAnimation {
+        uint32_t skin;
+        uint32_t index;
+        std::string name;
+        std::shared_ptr<const Animation> animation;
+    };
+
+    std::vector<std::optional<Texture>> textures;
+    std::vector<PendingAnimation> animations;
+    std::vector<std::optional<Mesh<SkinVertex>>> skinnedMeshes;
+    std::vector<std::optional<Mesh<RigidVertex>>> rigidMeshes;
+};
+
 void Document::loadDocument(const std::filesystem::path& path,
-                            const fx::gltf::Document& document) {
+                            const fx::gltf::Document& document,
+                            const BufferTable& buffers, ThreadPool& pool) {
     m_name = path.stem().string();
     std::unordered_map<uint32_t, uint32_t> skinMap{};
-    loadMaterials(path, document);
-    loadAnimations(document, skinMap);
-    loadMeshes(document, skinMap);
+    Import import{};
+    TaskGroup group{};
+    try {
+        loadMaterials(path, document, buffers, pool, group, import);
+        loadAnimations(document, buffers, skinMap, pool, group, import);
+        loadMeshes(document, buffers, skinMap, pool, group, import);
+    } catch (...) {
+        try {
+            pool.wait(group);
+        } catch (...) {
+        }
+        throw;
+    }
+    pool.wait(group);
+    finishImport(import);
 }
 
 void Document::loadMaterials(const std::filesystem::path& path,
-                             const fx::gltf::Document& document) {
-    auto& textures = at<Texture>();
-    textures.reserve(document.images.size());
+                             const fx::gltf::Document& document,
+                             const BufferTable& buffers, ThreadPool& pool,
+                             TaskGroup& group, Import& import) {
+    import.textures.resize(document.images.size());
     for (size_t i{0}; i < document.images.size(); i++) {
-        const auto& image = document.images[i];
-        textures.emplace_back(path, document, image);
+        pool.submit(group, [&, i]() {
+            import.textures[i].emplace(path, document, buffers,
+                                       document.images[i]);
+        });
     }
 
     auto& materials = at<pbrMaterial>();
@@ -110,6 +175,32 @@ void Document::loadMaterials(const std::filesystem::path& path,
     }
 }
 
+void Document::finishImport(Import& import) {
+    auto& textures = at<Texture>();
+    textures.reserve(import.textures.size());
+    for (auto& texture : import.textures) {
+        textures.push_back(std::move(*texture));
+    }
+
+    auto& skins = at<Skin>();
+    for (auto& pending : import.animations) {
+        skins[pending.skin].registerAnimation(std::move(pending.name),
+                                              std::move(pending.animation));
+    }
+
+    auto& skinnedMeshes = at<Mesh<SkinVertex>>();
+    skinnedMeshes.reserve(import.skinnedMeshes.size());
+    for (auto& mesh : import.skinnedMeshes) {
+        skinnedMeshes.push_back(std::move(*mesh));
+    }
+
+    auto& rigidMeshes = at<Mesh<RigidVertex>>();
+    rigidMeshes.reserve(import.rigidMeshes.size());
+    for (auto& mesh : import.rigidMeshes) {
+        rigidMeshes.push_back(std::move(*mesh));
+    }
+}
+
 class AnimParserHelper {
    public:
     void registerSkin(size_t skinIndex, const fx::gltf::Skin& skin) {
@@ -135,7 +226,10 @@ class AnimParserHelper {
 };
 
 void Document::loadAnimations(const fx::gltf::Document& document,
-                              std::unordered_map<uint32_t, uint32_t>& skinMap) {
+                              const BufferTable& buffers,
+                              std::unordered_map<uint32_t, uint32_t>& skinMap,
+                              ThreadPool& pool, TaskGroup& group,
+                              Import& import) {
     auto parentMap = getNodeParentMap(document);
     auto nodeTransforms = getNodeTransforms(document);
 
@@ -144,7 +238,7 @@ void Document::loadAnimations(const fx::gltf::Document& document,
     for (size_t i{0}; i < document.skins.size(); i++) {
         const auto& skin = document.skins[i];
         assocHelper.registerSkin(i, skin);
-        skins.emplace_back(document, skin, parentMap,
+        skins.emplace_back(document, buffers, skin, parentMap,
                            nodeTransforms.globalTransform,
                            nodeTransforms.inverseTransform);
     }
@@ -157,13 +251,21 @@ void Document::loadAnimations(const fx::gltf::Document& document,
                 auto animName = !animation.name.empty()
                                     ? animation.name
                                     : "Animation."s + std::to_string(i);
-                skins[skinID].registerAnimation(std::move(animName), document,
-                                                animation);
-                continue;
+                import.animations.push_back(Import::PendingAnimation{
+                    static_cast<uint32_t>(skinID), static_cast<uint32_t>(i),
+                    std::move(animName), nullptr});
             }
         }
     }
 
+    for (auto& pending : import.animations) {
+        pool.submit(group, [&]() {
+            pending.animation = std::make_shared<const Animation>(
+                document, buffers, document.animations[pending.index],
+                skins[pending.skin].m_meshNodeIndexMap);
+        });
+    }
+
     for (size_t i{0}; i < document.nodes.size(); i++) {
         const auto& node = document.nodes[i];
         if (node.skin != -1 && node.mesh != -1) {
@@ -173,8 +275,9 @@ void Document::loadAnimations(const fx::gltf::Document& document,
 }
 
 void Document::loadMeshes(
-    const fx::gltf::Document& document,
-    const std::unordered_map<uint32_t, uint32_t>& skinMap) {
+    const fx::gltf::Document& document, const BufferTable& buffers,
+    const std::unordered_map<uint32_t, uint32_t>& skinMap, ThreadPool& pool,
+    TaskGroup& group, Import& import) {
     auto getMaterialIndex =
         [](const fx::gltf::Primitive& primitive) -> std::optional<uint32_t> {
         if (primitive.material != -1) {
@@ -193,16 +296,16 @@ void Document::loadMeshes(
     };
 
     auto& skinModels = getModels<SkinVertex>();
-    auto& skinnedMeshes = at<Mesh<SkinVertex>>();
+    std::vector<const fx::gltf::Primitive*> skinnedPrimitives{};
     for (auto& [meshID, skinID] : skinMap) {
         Model<SkinVertex> model{};
         model.skin = skinID;
         const auto& mesh = document.meshes[meshID];
         for (size_t j{0}; j < mesh.primitives.size(); j++) {
             const auto& primitive = mesh.primitives[j];
-            skinnedMeshes.emplace_back(document, primitive);
+            skinnedPrimitives.push_back(&primitive);
             model.primitives.emplace_back(
-                Primitive{u32Checked(skinnedMeshes.size() - 1),
+                Primitive{u32Checked(skinnedPrimitives.size() - 1),
                           getMaterialIndex(primitive)});
         }
         std::string modelName =
@@ -211,7 +314,7 @@ void Document::loadMeshes(
     }
 
     auto& simpleModels = getModels<RigidVertex>();
-    auto& simpleMeshes = at<Mesh<RigidVertex>>();
+    std::vector<const fx::gltf::Primitive*> simplePrimitives{};
     for (size_t i{0}; i < document.meshes.size(); i++) {
         if (skinMap.count(i)) {
             continue;
@@ -220,15 +323,29 @@ void Document::loadMeshes(
         const auto& mesh = document.meshes[i];
         for (size_t j{0}; j < mesh.primitives.size(); j++) {
             const auto& primitive = mesh.primitives[j];
-            simpleMeshes.emplace_back(document, primitive);
+            simplePrimitives.push_back(&primitive);
             model.primitives.emplace_back(
-                Primitive{u32Checked(simpleMeshes.size() - 1),
+                Primitive{u32Checked(simplePrimitives.size() - 1),
                           getMaterialIndex(primitive)});
         }
         std::string modelName =
             !mesh.name.empty() ? mesh.name : "Mesh."s + std::to_string(i);
         simpleModels.emplace(std::move(modelName), std::move(model));
     }
+
+    import.skinnedMeshes.resize(skinnedPrimitives.size());
+    for (size_t i{0}; i < skinnedPrimitives.size(); i++) {
+        pool.submit(group, [&, i, primitive = skinnedPrimitives[i]]() {
+            import.skinnedMeshes[i].emplace(document, buffers, *primitive);
+        });
+    }
+
+    import.rigidMeshes.resize(simplePrimitives.size());
+    for (size_t i{0}; i < simplePrimitives.size(); i++) {
+        pool.submit(group, [&, i, primitive = simplePrimitives[i]]() {
+            import.rigidMeshes[i].emplace(document, buffers, *primitive);
+        });
+    }
 }
 
 }  // namespace gltf
@@ -0,0 +1,85 @@
+#include "rupture/graphics/gltf/mapped_document.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+using namespace std::string_literals;
+
+namespace gltf {
+
+MappedDocument::MappedDocument(const std::filesystem::path& path) {
+    auto ext = path.extension();
+    if (ext != ".gltf"s && ext != ".glb"s) {
+        throw std::invalid_argument("Invalid extension: " + path.string());
+    }
+
+    const auto& file = m_files.emplace_back(path);
+    Chunk json{file.data(), file.size()};
+    Chunk binary{nullptr, 0};
+    if (ext == ".glb"s) {
+        binary = binaryContainer(file, json);
+    }
+
+    m_document = nlohmann::json::parse(json.data, json.data + json.size)
+                     .get<fx::gltf::Document>();
+    mapBuffers(fx::gltf::detail::GetDocumentRootPath(path), binary);
+}
+
+MappedDocument::Chunk MappedDocument::binaryContainer(const MappedFile& file,
+                                                      Chunk& json) {
+    using namespace fx::gltf::detail;
+    GLBHeader header{};
+    if (file.size() < HeaderSize) {
+        throw std::runtime_error("Invalid GLB header");
+    }
+    std::memcpy(&header, file.data(), HeaderSize);
+    if (header.magic != GLBHeaderMagic || header.length > file.size() ||
+        header.jsonHeader.chunkType != GLBChunkJSON ||
+        header.jsonHeader.chunkLength > header.length - HeaderSize) {
+        throw std::runtime_error("Invalid GLB header");
+    }
+    json = Chunk{file.data() + HeaderSize, header.jsonHeader.chunkLength};
+
+    size_t offset = HeaderSize + header.jsonHeader.chunkLength;
+    if (offset + ChunkHeaderSize > header.length) {
+        return Chunk{nullptr, 0};
+    }
+    ChunkHeader binaryHeader{};
+    std::memcpy(&binaryHeader, file.data() + offset, ChunkHeaderSize);
+    offset += ChunkHeaderSize;
+    if (binaryHeader.chunkType != GLBChunkBIN ||
+        binaryHeader.chunkLength > header.length - offset) {
+        throw std::runtime_error("Invalid GLB binary chunk");
+    }
+    return Chunk{file.data() + offset, binaryHeader.chunkLength};
+}
+
+void MappedDocument::mapBuffers(const std::filesystem::path& root,
+                                Chunk binary) {
+    for (size_t i{0}; i < m_document.buffers.size(); i++) {
+        auto& buffer = m_document.buffers[i];
+        if (buffer.byteLength == 0) {
+            throw std::runtime_error("Invalid buffer byte length");
+        }
+
+        if (buffer.uri.empty()) {
+            if (binary.size < buffer.byteLength) {
+                throw std::runtime_error("Invalid GLB buffer data");
+            }
+            m_buffers.assign(i, binary.data, buffer.byteLength);
+        } else if (buffer.IsEmbeddedResource()) {
+            fx::gltf::detail::MaterializeData(buffer);
+            m_buffers.assign(i, buffer.data.data(), buffer.data.size());
+        } else {
+            const auto& external = m_files.emplace_back(
+                fx::gltf::detail::CreateBufferUriPath(root, buffer.uri));
+            if (external.size() < buffer.byteLength) {
+                throw std::runtime_error("Invalid buffer uri: " + buffer.uri);
+            }
+            m_buffers.assign(i, external.data(), buffer.byteLength);
+        }
+    }
+}
+
+}  // namespace gltf
@@ -1,5 +1,6 @@
 #include "rupture/graphics/gltf/skin.h"
 
+#include <algorithm>
 #include <cstring>
 #include <iostream>
 #include <queue>
@@ -9,7 +10,24 @@
 
 namespace gltf {
 
-Skin::Skin(const fx::gltf::Document& document, const fx::gltf::Skin& skin,
+namespace {
+
+glm::mat4x3 affineMultiply(const glm::mat4x3& a, const glm::mat4x3& b) {
+    glm::mat4x3 result;
+    for (int column{0}; column < 4; column++) {
+        const auto& v = b[column];
+        result[column] = {a[0].x * v.x + a[1].x * v.y + a[2].x * v.z,
+                          a[0].y * v.x + a[1].y * v.y + a[2].y * v.z,
+                          a[0].z * v.x + a[1].z * v.y + a[2].z * v.z};
+    }
+    result[3] += a[3];
+    return result;
+}
+
+}  // namespace
+
+Skin::Skin(const fx::gltf::Document& document, const BufferTable& buffers,
+           const fx::gltf::Skin& skin,
            const std::unordered_map<uint32_t, uint32_t>& parentMap,
            const std::vector<glm::mat4>& globalTransforms,
            const std::vector<glm::mat4>& inverseTransforms) {
@@ -21,7 +39,7 @@ Skin::Skin(const fx::gltf::Document& document, const fx::gltf::Skin& skin,
     if (skin.inverseBindMatrices != -1) {
         const auto& bindAccesor = document.accessors[skin.inverseBindMatrices];
         auto inverseBind =
-            gltf::readContiguous<glm::mat4>(document, bindAccesor);
+            gltf::readContiguous<glm::mat4>(document, buffers, bindAccesor);
         if (inverseBind.size() != skin.joints.size()) {
             throw std::runtime_error("Incomplete skin data");
         }
@@ -65,8 +83,198 @@ Skin::Skin(const fx::gltf::Document& document, const fx::gltf::Skin& skin,
             }
         }
     }
+
+    m_parents.assign(m_joints.size(), NO_PARENT);
+    m_skinIndices.reserve(m_joints.size());
+    m_inverseBinds.reserve(m_joints.size());
+    for (size_t i{0}; i < m_joints.size(); i++) {
+        const auto& joint = m_joints[i];
+        for (size_t j{0}; j < joint.numChildren; j++) {
+            m_parents[joint.firstChild + j] = i;
+        }
+        m_skinIndices.push_back(m_skinIndexJointMap.at(joint.nodeId));
+        m_inverseBinds.emplace_back(joint.inverseBind);
+    }
 };
 
+void Skin::jointMatrices(const glm::mat4& rootTransform, size_t animation,
+                         float time, Workspace& workspace, glm::mat4* output,
+                         bool freezeLeaves) const {
+    auto& pose = workspace.m_pose;
+    if (pose.jointCount() != m_joints.size()) {
+        pose.resize(m_joints.size(), 1);
+        freezeLeaves = false;
+    }
+    samplePose(animation, time, workspace, pose.view(0), freezeLeaves);
+    poseMatrices(rootTransform, pose.view(0), workspace, output);
+}
+
+void Skin::samplePose(size_t animation, float time, Workspace& workspace,
+                      const PoseView& pose, bool freezeLeaves) const {
+    if (pose.jointCount() != m_joints.size()) {
+        throw std::out_of_range("Pose does not fit the skin");
+    }
+    const auto& samplers = freezeLeaves ? m_leafFrozenSamplers : m_samplers;
+    samplers.at(animation).sample(time, workspace.m_cursor, pose);
+}
+
+void Skin::poseMatrices(const glm::mat4& rootTransform, const PoseView& pose,
+                        Workspace& workspace, glm::mat4* output) const {
+    if (pose.jointCount() != m_joints.size()) {
+        throw std::out_of_range("Pose does not fit the skin");
+    }
+    auto& transforms = workspace.m_transforms;
+    transforms.resize(m_joints.size());
+
+    const auto* tx = pose.component(PoseBuffer::TranslationX);
+    const auto* ty = pose.component(PoseBuffer::TranslationY);
+    const auto* tz = pose.component(PoseBuffer::TranslationZ);
+    const auto* rx = pose.component(PoseBuffer::RotationX);
+    const auto* ry = pose.component(PoseBuffer::RotationY);
+    const auto* rz = pose.component(PoseBuffer::RotationZ);
+    const auto* rw = pose.component(PoseBuffer::RotationW);
+    const auto* sx = pose.component(PoseBuffer::ScaleX);
+    const auto* sy = pose.component(PoseBuffer::ScaleY);
+    const auto* sz = pose.component(PoseBuffer::ScaleZ);
+
+    const glm::mat4x3 root{rootTransform * m_rootTransform};
+    for (size_t i{0}; i < m_joints.size(); i++) {
+        auto xx = rx[i] * rx[i], yy = ry[i] * ry[i], zz = rz[i] * rz[i];
+        auto xy = rx[i] * ry[i], xz = rx[i] * rz[i], yz = ry[i] * rz[i];
+        auto wx = rw[i] * rx[i], wy = rw[i] * ry[i], wz = rw[i] * rz[i];
+        glm::mat4x3 local{
+            glm::vec3{1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz),
+                      2.0f * (xz - wy)} *
+                sx[i],
+            glm::vec3{2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz),
+                      2.0f * (yz + wx)} *
+                sy[i],
+            glm::vec3{2.0f * (xz + wy), 2.0f * (yz - wx),
+                      1.0f - 2.0f * (xx + yy)} *
+                sz[i],
+            glm::vec3{tx[i], ty[i], tz[i]}};
+        auto parent = m_parents[i];
+        transforms[i] = affineMultiply(
+            parent == NO_PARENT ? root : transforms[parent], local);
+        output[m_skinIndices[i]] =
+            glm::mat4{affineMultiply(transforms[i], m_inverseBinds[i])};
+    }
+}
+
+void Skin::compressAnimations(const CompressionSettings& settings) {
+    for (size_t i{0}; i < m_samplers.size(); i++) {
+        if (m_samplers[i].compressed()) {
+            continue;
+        }
+        m_samplers[i] = AnimationSampler{
+            std::make_shared<const CompressedAnimation>(*m_animations[i],
+                                                        settings)};
+        m_animations[i].reset();
+        registerSampler(i);
+    }
+}
+
+Skin::RootMotion Skin::rootMotion(size_t animation, float from, float to,
+                                  Workspace& workspace) const {
+    auto start = rootTransform(animation, from, workspace);
+    auto end = rootTransform(animation, to, workspace);
+    if (to >= from) {
+        return {end.translation - start.translation,
+                glm::normalize(end.rotation * glm::inverse(start.rotation))};
+    }
+
+    auto duration = static_cast<float>(m_samplers.at(animation).duration());
+    auto first = rootTransform(animation, 0.0f, workspace);
+    auto last = rootTransform(animation, duration, workspace);
+    return {(last.translation - start.translation) +
+                (end.translation - first.translation),
+            glm::normalize(end.rotation * glm::inverse(first.rotation) *
+                           last.rotation * glm::inverse(start.rotation))};
+}
+
+void Skin::removeRootMotion(size_t animation, const PoseView& pose,
+                            Workspace& workspace) const {
+    if (pose.jointCount() != m_joints.size()) {
+        throw std::out_of_range("Pose does not fit the skin");
+    }
+    auto reference = rootTransform(animation, 0.0f, workspace);
+    pose.component(PoseBuffer::TranslationX)[0] = reference.translation.x;
+    pose.component(PoseBuffer::TranslationY)[0] = reference.translation.y;
+    pose.component(PoseBuffer::TranslationZ)[0] = reference.translation.z;
+    pose.component(PoseBuffer::RotationX)[0] = reference.rotation.x;
+    pose.component(PoseBuffer::RotationY)[0] = reference.rotation.y;
+    pose.component(PoseBuffer::RotationZ)[0] = reference.rotation.z;
+    pose.component(PoseBuffer::RotationW)[0] = reference.rotation.w;
+}
+
+void Skin::registerSampler(size_t animation) {
+    std::vector<bool> leaves(m_joints.size(), false);
+    std::vector<bool> descendants(m_joints.size(), true);
+    for (size_t i{1}; i < m_joints.size(); i++) {
+        leaves[i] = m_joints[i].numChildren == 0;
+    }
+    if (!descendants.empty()) {
+        descendants[0] = false;
+    }
+
+    const auto& sampler = m_samplers.at(animation);
+    auto leafFrozen = sampler.withFrozenJoints(leaves);
+    auto root = sampler.withFrozenJoints(descendants);
+    if (animation < m_rootSamplers.size()) {
+        m_leafFrozenSamplers[animation] = std::move(leafFrozen);
+        m_rootSamplers[animation] = std::move(root);
+    } else {
+        m_leafFrozenSamplers.push_back(std::move(leafFrozen));
+        m_rootSamplers.push_back(std::move(root));
+    }
+}
+
+Skin::RootMotion Skin::rootTransform(size_t animation, float time,
+                                     Workspace& workspace) const {
+    auto& pose = workspace.m_rootPose;
+    if (pose.jointCount() != m_joints.size()) {
+        pose.resize(m_joints.size(), 1);
+    }
+    m_rootSamplers.at(animation).sample(time, workspace.m_rootCursor, pose);
+    return {pose.translation(0, 0), pose.rotation(0, 0)};
+}
+
+void Skin::restPose(const PoseView& pose) const {
+    if (pose.jointCount() != m_joints.size()) {
+        throw std::out_of_range("Pose does not fit the skin");
+    }
+    for (size_t i{0}; i < m_joints.size(); i++) {
+        const auto& joint = m_joints[i];
+        pose.component(PoseBuffer::TranslationX)[i] = joint.t.x;
+        pose.component(PoseBuffer::TranslationY)[i] = joint.t.y;
+        pose.component(PoseBuffer::TranslationZ)[i] = joint.t.z;
+        pose.component(PoseBuffer::RotationX)[i] = joint.r.x;
+        pose.component(PoseBuffer::RotationY)[i] = joint.r.y;
+        pose.component(PoseBuffer::RotationZ)[i] = joint.r.z;
+        pose.component(PoseBuffer::RotationW)[i] = joint.r.w;
+        pose.component(PoseBuffer::ScaleX)[i] = joint.s.x;
+        pose.component(PoseBuffer::ScaleY)[i] = joint.s.y;
+        pose.component(PoseBuffer::ScaleZ)[i] = joint.s.z;
+    }
+}
+
+std::vector<float> Skin::boneMask(const std::string& jointName) const {
+    auto it = std::find_if(
+        m_joints.begin(), m_joints.end(),
+        [&](const Joint& joint) { return joint.name == jointName; });
+    if (it == m_joints.end()) {
+        throw std::out_of_range("Unknown joint " + jointName);
+    }
+    std::vector<float> mask(m_joints.size(), 0.0f);
+    mask[it - m_joints.begin()] = 1.0f;
+    for (size_t i{0}; i < m_joints.size(); i++) {
+        if (m_parents[i] != NO_PARENT && mask[m_parents[i]] != 0.0f) {
+            mask[i] = 1.0f;
+        }
+    }
+    return mask;
+}
+
 std::string Skin::getGltfUID(const std::filesystem::path& path,
                              const fx::gltf::Document& document,
                              size_t skinIndex) {
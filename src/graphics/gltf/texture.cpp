@@ -4,8 +4,10 @@
 
 #include <stb_image.h>
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
+#include <stdexcept>
 
 #include "magic_enum.hpp"
 
@@ -30,7 +32,7 @@ Texture::Texture(const uint8_t* bytes, size_t byteLength, Format format)
 
 Texture::Texture(const std::filesystem::path& path,
                  const fx::gltf::Document& document,
-                 const fx::gltf::Image& image)
+                 const BufferTable& buffers, const fx::gltf::Image& image)
     : m_format(Format::RGBA) {
     if (image.IsEmbeddedResource() && !image.uri.empty()) {
         std::vector<uint8_t> imageData{};
@@ -39,9 +41,10 @@ Texture::Texture(const std::filesystem::path& path,
     } else if (!image.uri.empty()) {
         loadFile(fx::gltf::detail::GetDocumentRootPath(path) / image.uri);
     } else {
-        const auto& bufferView = document.bufferViews[image.bufferView];
-        const auto& buffer = document.buffers[bufferView.buffer];
-        loadBytes(&buffer.data[bufferView.byteOffset], bufferView.byteLength);
+        const auto& bufferView = document.bufferViews.at(image.bufferView);
+        loadBytes(buffers.data(bufferView.buffer, bufferView.byteOffset,
+                               bufferView.byteLength),
+                  bufferView.byteLength);
     }
 }
 
@@ -83,6 +86,67 @@ void Texture::loadBytes(const uint8_t* bytes, size_t byteLength) {
     }
 }
 
+void Texture::generateMipmaps() {
+    if (m_mipLevels > 1) {
+        return;
+    }
+    size_t components = enum_integer(m_format);
+    size_t levels{1};
+    while (mipWidth(levels - 1) > 1 || mipHeight(levels - 1) > 1) {
+        levels++;
+    }
+
+    size_t chainSize{0};
+    for (size_t level{0}; level < levels; level++) {
+        chainSize += mipWidth(level) * mipHeight(level) * components;
+    }
+    m_imageData.resize(chainSize);
+
+    size_t sourceOffset{0};
+    for (size_t level{1}; level < levels; level++) {
+        auto sourceWidth = mipWidth(level - 1);
+        auto sourceHeight = mipHeight(level - 1);
+        auto width = mipWidth(level);
+        auto height = mipHeight(level);
+        auto targetOffset =
+            sourceOffset + sourceWidth * sourceHeight * components;
+        const auto* source = m_imageData.data() + sourceOffset;
+        auto* target = m_imageData.data() + targetOffset;
+        for (size_t y{0}; y < height; y++) {
+            const auto* row0 =
+                source + std::min(y * 2, sourceHeight - 1) * sourceWidth *
+                             components;
+            const auto* row1 =
+                source + std::min(y * 2 + 1, sourceHeight - 1) *
+                             sourceWidth * components;
+            for (size_t x{0}; x < width; x++) {
+                auto x0 = std::min(x * 2, sourceWidth - 1) * components;
+                auto x1 = std::min(x * 2 + 1, sourceWidth - 1) * components;
+                for (size_t c{0}; c < components; c++) {
+                    auto sum = row0[x0 + c] + row0[x1 + c] + row1[x0 + c] +
+                               row1[x1 + c];
+                    target[(y * width + x) * components + c] =
+                        static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        sourceOffset = targetOffset;
+    }
+    m_mipLevels = levels;
+}
+
+size_t Texture::mipOffset(size_t level) const {
+    if (level >= m_mipLevels) {
+        throw std::out_of_range("Texture mip level out of range");
+    }
+    size_t components = enum_integer(m_format);
+    size_t offset{0};
+    for (size_t i{0}; i < level; i++) {
+        offset += mipWidth(i) * mipHeight(i) * components;
+    }
+    return offset;
+}
+
 std::string Texture::getGltfUID(const std::filesystem::path& path,
                                 const fx::gltf::Document& document,
                                 uint32_t index) {
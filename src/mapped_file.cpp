@@ -0,0 +1,80 @@
+#include "rupture/mapped_file.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#endif
+
+#include <stdexcept>
+#include <utility>
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    auto descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    struct stat status {};
+    if (::fstat(descriptor, &status) != 0) {
+        ::close(descriptor);
+        throw std::runtime_error("Failed to stat file: " + path.string());
+    }
+    m_size = static_cast<size_t>(status.st_size);
+    if (m_size > 0) {
+        auto* mapping =
+            ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (mapping == MAP_FAILED) {
+            ::close(descriptor);
+            throw std::runtime_error("Failed to map file: " + path.string());
+        }
+        ::madvise(mapping, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const uint8_t*>(mapping);
+        m_mapped = true;
+    }
+    ::close(descriptor);
+#else
+    std::ifstream input{path, std::ios::binary | std::ios::ate};
+    if (!input.is_open()) {
+        throw std::runtime_error("Failed to open file: " + path.string());
+    }
+    m_fallback.resize(static_cast<size_t>(input.tellg()));
+    input.seekg(0);
+    input.read(reinterpret_cast<char*>(m_fallback.data()), m_fallback.size());
+    m_data = m_fallback.data();
+    m_size = m_fallback.size();
+#endif
+}
+
+MappedFile::~MappedFile() { release(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)},
+      m_size{std::exchange(other.m_size, 0)},
+      m_mapped{std::exchange(other.m_mapped, false)},
+      m_fallback{std::move(other.m_fallback)} {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mapped = std::exchange(other.m_mapped, false);
+        m_fallback = std::move(other.m_fallback);
+    }
+    return *this;
+}
+
+void MappedFile::release() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (m_mapped) {
+        ::munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+#endif
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
@@ -0,0 +1,106 @@
+#include "rupture/profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+void writeEscaped(std::ostream& out, const char* text) {
+    for (; *text != '\0'; text++) {
+        auto c = *text;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+}
+
+}  // namespace
+
+Profiler::Profiler(size_t capacity)
+    : m_epoch{Clock::now()}, m_samples(std::max<size_t>(capacity, 1)) {}
+
+int64_t Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() -
+                                                                m_epoch)
+        .count();
+}
+
+void Profiler::record(const char* name, int64_t begin, int64_t end) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_samples[m_next] = Sample{name,    Timeline::Cpu, threadIndex(),
+                               frame(), begin,         end - begin};
+    m_next = (m_next + 1) % m_samples.size();
+    m_count = std::min(m_count + 1, m_samples.size());
+}
+
+void Profiler::record(const Sample& sample) {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_samples[m_next] = sample;
+    m_next = (m_next + 1) % m_samples.size();
+    m_count = std::min(m_count + 1, m_samples.size());
+}
+
+std::vector<Profiler::Sample> Profiler::samples() const {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    std::vector<Sample> result{};
+    result.reserve(m_count);
+    auto first = (m_next + m_samples.size() - m_count) % m_samples.size();
+    for (size_t i{0}; i < m_count; i++) {
+        result.push_back(m_samples[(first + i) % m_samples.size()]);
+    }
+    return result;
+}
+
+size_t Profiler::size() const {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_count;
+}
+
+void Profiler::clear() {
+    std::lock_guard<std::mutex> lock{m_mutex};
+    m_next = 0;
+    m_count = 0;
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    out << "{\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,"
+           "\"args\":{\"name\":\"CPU\"}},\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+           "\"args\":{\"name\":\"GPU\"}}";
+    for (const auto& sample : samples()) {
+        out << ",\n{\"name\":\"";
+        writeEscaped(out, sample.name);
+        out << "\",\"ph\":\"X\",\"pid\":"
+            << (sample.timeline == Timeline::Gpu ? 1 : 0)
+            << ",\"tid\":" << sample.thread
+            << ",\"ts\":" << static_cast<double>(sample.begin) / 1000.0
+            << ",\"dur\":" << static_cast<double>(sample.duration) / 1000.0
+            << ",\"args\":{\"frame\":" << sample.frame << "}}";
+    }
+    out << "\n]}\n";
+}
+
+void Profiler::writeChromeTrace(const std::filesystem::path& path) const {
+    std::ofstream out{path};
+    if (!out) {
+        throw std::runtime_error("Failed to open trace file " +
+                                 path.string());
+    }
+    writeChromeTrace(out);
+}
+
+uint32_t Profiler::threadIndex() {
+    auto id = std::this_thread::get_id();
+    auto found = std::find(m_threads.begin(), m_threads.end(), id);
+    if (found == m_threads.end()) {
+        m_threads.push_back(id);
+        return static_cast<uint32_t>(m_threads.size() - 1);
+    }
+    return static_cast<uint32_t>(found - m_threads.begin());
+}
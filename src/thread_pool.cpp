@@ -0,0 +1,144 @@
+#include "rupture/thread_pool.h"
+
+#include <limits>
+
+namespace {
+
+constexpr size_t NOT_A_WORKER = std::numeric_limits<size_t>::max();
+
+thread_local const ThreadPool* currentPool{nullptr};
+thread_local size_t currentWorker{NOT_A_WORKER};
+
+}  // namespace
+
+ThreadPool::ThreadPool(size_t workerCount) {
+    m_queues.reserve(std::max<size_t>(workerCount, 1));
+    for (size_t i{0}; i < std::max<size_t>(workerCount, 1); i++) {
+        m_queues.emplace_back(std::make_unique<Queue>());
+    }
+    m_threads.reserve(workerCount);
+    for (size_t i{0}; i < workerCount; i++) {
+        m_threads.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock{m_sleepMutex};
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::submit(TaskGroup& group, Task task) {
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+    m_queued.fetch_add(1, std::memory_order_release);
+
+    auto index = localQueue();
+    if (index == NOT_A_WORKER) {
+        index = m_nextQueue.fetch_add(1, std::memory_order_relaxed) %
+                m_queues.size();
+    }
+    {
+        auto& queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        queue.jobs.push_back(Job{std::move(task), &group});
+    }
+    { std::lock_guard<std::mutex> lock{m_sleepMutex}; }
+    m_wakeup.notify_one();
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    auto index = localQueue();
+    while (!group.done()) {
+        if (!tryRunOne(index == NOT_A_WORKER ? 0 : index)) {
+            std::this_thread::yield();
+        }
+    }
+    if (group.m_error) {
+        auto error = group.m_error;
+        group.m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+bool ThreadPool::runOne() {
+    auto index = localQueue();
+    return tryRunOne(index == NOT_A_WORKER ? 0 : index);
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock{m_sleepMutex};
+            m_wakeup.wait(lock, [this]() {
+                return m_stop || m_queued.load(std::memory_order_acquire) > 0;
+            });
+            if (m_stop) {
+                return;
+            }
+        }
+        while (tryRunOne(index)) {
+        }
+    }
+}
+
+bool ThreadPool::tryRunOne(size_t index) {
+    Job job{};
+    if (pop(index, job) || steal(index, job)) {
+        m_queued.fetch_sub(1, std::memory_order_acq_rel);
+        execute(job);
+        return true;
+    }
+    return false;
+}
+
+bool ThreadPool::pop(size_t index, Job& job) {
+    auto& queue = *m_queues[index];
+    std::lock_guard<std::mutex> lock{queue.mutex};
+    if (queue.jobs.empty()) {
+        return false;
+    }
+    job = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool ThreadPool::steal(size_t thief, Job& job) {
+    for (size_t i{1}; i < m_queues.size(); i++) {
+        auto& queue = *m_queues[(thief + i) % m_queues.size()];
+        std::lock_guard<std::mutex> lock{queue.mutex};
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Job& job) {
+    try {
+        job.task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock{job.group->m_errorMutex};
+        if (!job.group->m_error) {
+            job.group->m_error = std::current_exception();
+        }
+    }
+    job.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+size_t ThreadPool::threadIndex() const {
+    auto local = localQueue();
+    return local == NOT_A_WORKER ? m_threads.size() : local;
+}
+
+size_t ThreadPool::localQueue() const {
+    return currentPool == this ? currentWorker : NOT_A_WORKER;
+}